@@ -11,3 +11,7 @@ target_compile_options(
             # -Wunreachable-code -Wstrict-aliasing=2 -ffloat-store -fno-common
             # -fstrict-aliasing -pedantic
 )
+
+if(DLIB_NATIVE_ARCH)
+  target_compile_options(compile_flags INTERFACE -march=native)
+endif()
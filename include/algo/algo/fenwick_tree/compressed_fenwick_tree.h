@@ -0,0 +1,130 @@
+#pragma once
+
+#include "algo/common/types.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace algo::fwt {
+
+/**
+ * @brief Two-dimensional Fenwick tree over a sparse set of points known in advance.
+ *
+ * The rows are compressed to the distinct x coordinates of the points, and every row of the tree
+ * keeps only the y coordinates of the points that propagate to it, in its own one-dimensional
+ * Fenwick tree. This takes O(P log P) memory for P points instead of the dims[0] * dims[1] cells of
+ * FenwickTree<T, Op, 2>, so the coordinates may be arbitrarily large.
+ *
+ * Only the points passed to the constructor may be updated. Queries accept any coordinates and
+ * have the same semantics as FenwickTree. Both take O(log^2 P) time.
+ */
+template <typename T, typename Op>
+class CompressedFenwickTree : public types::StatelessEngineBase<2> {
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<2>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<2>::RangeQueryHandle;
+
+  explicit CompressedFenwickTree(std::span<const types::Index<2>> points) {
+    for (const auto& point : points) {
+      xs_.push_back(point[0]);
+    }
+    std::sort(xs_.begin(), xs_.end());
+    xs_.erase(std::unique(xs_.begin(), xs_.end()), xs_.end());
+
+    std::vector<std::vector<size_t>> columns(xs_.size());
+    for (const auto& point : points) {
+      for (size_t row = rowOf(point[0]); row < xs_.size(); row = (row | (row + 1))) {
+        columns[row].push_back(point[1]);
+      }
+    }
+
+    offsets_.reserve(xs_.size() + 1);
+    offsets_.push_back(0);
+    for (auto& row : columns) {
+      std::sort(row.begin(), row.end());
+      row.erase(std::unique(row.begin(), row.end()), row.end());
+      ys_.insert(ys_.end(), row.begin(), row.end());
+      offsets_.push_back(ys_.size());
+    }
+    storage_.assign(ys_.size(), op_.neutral());
+  }
+
+  /**
+   * @brief Updates the value at the point, which must be one of the points passed to the constructor.
+   */
+  void update(QueryHandle& handle, const T& value) {
+    size_t x = handle.getIndex()[0];
+    size_t y = handle.getIndex()[1];
+    assert(rowOf(x) < xs_.size() && xs_[rowOf(x)] == x && !!"point was not passed to the constructor");
+    for (size_t row = rowOf(x); row < xs_.size(); row = (row | (row + 1))) {
+      auto [first, last] = columnsOf(row);
+      size_t size = last - first;
+      auto it = std::lower_bound(first, last, y);
+      assert(it != last && *it == y && !!"point was not passed to the constructor");
+      for (size_t column = it - first; column < size; column = (column | (column + 1))) {
+        op_.update(storage_[offsets_[row] + column], value);
+      }
+    }
+  }
+
+  T query(QueryHandle& handle) {
+    size_t x = handle.getIndex()[0];
+    size_t y = handle.getIndex()[1];
+    T result = op_.neutral();
+
+    // The number of rows with x coordinates not greater than x
+    int64_t rows = std::upper_bound(xs_.begin(), xs_.end(), x) - xs_.begin();
+    for (int64_t row = rows - 1; row >= 0; row = (row & (row + 1)) - 1) {
+      auto [first, last] = columnsOf(row);
+      int64_t columns = std::upper_bound(first, last, y) - first;
+      for (int64_t column = columns - 1; column >= 0; column = (column & (column + 1)) - 1) {
+        result = op_(result, storage_[offsets_[row] + column]);
+      }
+    }
+    return result;
+  }
+
+  T query(RangeQueryHandle& handle) {
+    auto& [ql, qr] = handle.getRange();
+    types::Index<2> q;
+    T result = op_.neutral();
+
+    q = qr;
+    result = op_(result, query(q));
+    if (ql[0] > 0) {
+      q = {{ql[0] - 1, qr[1]}};
+      result = op_(result, op_.inv(query(q)));
+    }
+    if (ql[1] > 0) {
+      q = {{qr[0], ql[1] - 1}};
+      result = op_(result, op_.inv(query(q)));
+    }
+    if (ql[0] > 0 && ql[1] > 0) {
+      q = {{ql[0] - 1, ql[1] - 1}};
+      result = op_(result, query(q));
+    }
+    return result;
+  }
+
+ private:
+  size_t rowOf(size_t x) const noexcept {
+    return std::lower_bound(xs_.begin(), xs_.end(), x) - xs_.begin();
+  }
+
+  auto columnsOf(size_t row) const noexcept {
+    return std::make_pair(ys_.begin() + offsets_[row], ys_.begin() + offsets_[row + 1]);
+  }
+
+  [[no_unique_address]] Op op_;
+  std::vector<size_t> xs_;
+  std::vector<size_t> offsets_;
+  std::vector<size_t> ys_;
+  std::vector<T> storage_;
+};
+
+}  // namespace algo::fwt
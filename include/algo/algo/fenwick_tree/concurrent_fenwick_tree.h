@@ -0,0 +1,144 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/fenwick_tree/fenwick_tree.h"
+#include "algo/utility/nd_container.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace algo::fwt {
+
+/**
+ * @brief Fenwick tree of sums which may be updated and queried from many threads at once.
+ *
+ * Every node is a std::atomic<T> incremented with a relaxed fetch_add, so concurrent updates never
+ * block each other and none of them is lost. A query that runs concurrently with updates may see an
+ * update only in some of the nodes it reads, i.e. partially applied. Once the updates are complete
+ * (and synchronized with the querying thread), queries are exact.
+ */
+template <typename T, size_t NDims = 1>
+class ConcurrentFenwickTree : public types::StatelessEngineBase<NDims> {
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<NDims>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<NDims>::RangeQueryHandle;
+
+  explicit ConcurrentFenwickTree(const types::Index<NDims>& dims) {
+    initDims(dims);
+  }
+
+  explicit ConcurrentFenwickTree(utility::NDView<T, NDims> auto view) {
+    types::Index<NDims> d;
+    view.getDimensions(d);
+    initDims(d);
+
+    std::vector<T> values(storage_.size(), T(0));
+    init<0>(view, values, d, 0);
+    build(values);
+    for (size_t i = 0; i < values.size(); ++i) {
+      storage_[i].store(values[i], std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Adds value to the element. Thread-safe.
+   */
+  void update(QueryHandle& handle, const T& value) {
+    update<0>(handle.getIndex(), 0, value);
+  }
+
+  /**
+   * @brief Returns the sum of elements in [0, index]. Thread-safe.
+   */
+  T query(QueryHandle& handle) const {
+    T result = T(0);
+    query<0>(result, handle.getIndex(), 0);
+    return result;
+  }
+
+  /**
+   * @brief Returns the sum of elements in the range. Thread-safe.
+   */
+  T query(RangeQueryHandle& handle) const {
+    types::Index<NDims> q;
+    T result = T(0);
+    query<0, 1>(result, q, handle.getRange().left, handle.getRange().right);
+    return result;
+  }
+
+ private:
+  template <size_t I>
+  void query(T& result, const types::Index<NDims>& qr, size_t index) const {
+    for (int64_t i = qr[I]; i >= 0; i = (i & (i + 1)) - 1) {
+      if constexpr (I == NDims - 1) {
+        result += storage_[index + i].load(std::memory_order_relaxed);
+      } else {
+        query<I + 1>(result, qr, index + i * strides_[I]);
+      }
+    }
+  }
+
+  template <size_t I, int Sign>
+  void query(T& result, types::Index<NDims>& q, const types::Index<NDims>& ql, const types::Index<NDims>& qr) const {
+    q[I] = ql[I] - 1;
+    if constexpr (I == NDims - 1) {
+      T x = query(q);
+      result += Sign == -1 ? x : -x;
+    } else {
+      query<I + 1, -Sign>(result, q, ql, qr);
+    }
+    q[I] = qr[I];
+    if constexpr (I == NDims - 1) {
+      T x = query(q);
+      result += Sign == 1 ? x : -x;
+    } else {
+      query<I + 1, Sign>(result, q, ql, qr);
+    }
+  }
+
+  template <size_t I>
+  void update(const types::Index<NDims>& cs, size_t index, const T& value) {
+    for (auto i = cs[I]; i < dims_[I]; i = (i | (i + 1))) {
+      if constexpr (I == NDims - 1) {
+        storage_[index + i].fetch_add(value, std::memory_order_relaxed);
+      } else {
+        update<I + 1>(cs, index + i * strides_[I], value);
+      }
+    }
+  }
+
+  template <size_t I, utility::NDView<T, NDims> NDView>
+  void init(const NDView& a, std::vector<T>& values, types::Index<NDims>& idxs, size_t index) {
+    for (size_t i = 0; i < dims_[I]; ++i) {
+      idxs[I] = i;
+      if constexpr (I == NDims - 1) {
+        values[index + i] = a.at(idxs);
+      } else {
+        init<I + 1>(a, values, idxs, index + i * strides_[I]);
+      }
+    }
+  }
+
+  void build(std::vector<T>& values) {
+    detail::buildLinear(values, dims_, strides_, [](T& parent, const T& child) { parent += child; });
+  }
+
+  void initDims(const types::Index<NDims>& d) {
+    std::copy(d.begin(), d.end(), dims_.begin());
+    size_t stride = 1;
+    for (size_t dim = NDims; dim-- > 0;) {
+      strides_[dim] = stride;
+      stride *= dims_[dim];
+    }
+    storage_ = std::vector<std::atomic<T>>(stride);
+  }
+
+  types::Index<NDims> dims_;
+  types::Index<NDims> strides_;
+  std::vector<std::atomic<T>> storage_;
+};
+
+}  // namespace algo::fwt
@@ -3,14 +3,48 @@
 #include "algo/common/types.h"
 #include "algo/utility/nd_container.h"
 
+#include <bit>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace algo::fwt {
 
+namespace detail {
+
+/**
+ * @brief Turns the values into the tree in O(N): along each dimension every cell is added to its
+ * parent i | (i + 1) once, after all of its own children have been added to it.
+ *
+ * add(parent, child) must add the cell child to the cell parent.
+ */
+template <typename Cell, size_t NDims, typename Add>
+void buildLinear(
+    std::vector<Cell>& cells, const types::Index<NDims>& dims, const types::Index<NDims>& strides, const Add& add) {
+  for (size_t dim = 0; dim < NDims; ++dim) {
+    size_t n = dims[dim];
+    size_t stride = strides[dim];
+
+    for (size_t outer = 0; outer < cells.size(); outer += n * stride) {
+      for (size_t i = 0; i < n; ++i) {
+        size_t parent = i | (i + 1);
+        if (parent >= n) {
+          continue;
+        }
+        for (size_t j = 0; j < stride; ++j) {
+          add(cells[outer + parent * stride + j], cells[outer + i * stride + j]);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
 template <typename T, typename Op, size_t NDims = 1>
 class FenwickTree : public types::StatelessEngineBase<NDims> {
  public:
@@ -25,13 +59,46 @@ class FenwickTree : public types::StatelessEngineBase<NDims> {
     types::Index<NDims> d;
     view.getDimensions(d);
     initDims(d);
-    init<0>(view, d);
+    init<0>(view, d, 0);
+    build(storage_);
   }
 
   void update(QueryHandle& handle, const T& value) {
     update<0>(handle.getIndex(), 0, value);
   }
 
+  /**
+   * @brief Applies the updates as if update() was called for each of them.
+   *
+   * When the propagation chains of the updates would cover a number of nodes comparable to the
+   * whole tree, the updates are accumulated into a separate array, which is built in linear time
+   * and merged into the tree. Sparser batches are applied one by one.
+   */
+  void updateBatch(std::span<const std::pair<types::Index<NDims>, T>> updates) {
+    size_t chain = 1;
+    for (size_t dim = 0; dim < NDims; ++dim) {
+      chain *= std::bit_width(dims_[dim]);
+    }
+
+    // A rebuild costs about twice as much per node as a step of update()
+    if (updates.size() * chain < 2 * storage_.size()) {
+      for (const auto& [index, value] : updates) {
+        update<0>(index, 0, value);
+      }
+      return;
+    }
+
+    std::vector<T> delta(storage_.size(), op_.neutral());
+    for (const auto& [index, value] : updates) {
+      op_.update(delta[linearIndex(index)], value);
+    }
+
+    build(delta);
+    for (size_t i = 0; i < storage_.size(); ++i) {
+      op_.update(storage_[i], delta[i]);
+    }
+  }
+
   T query(QueryHandle& handle) {
     T result = op_.neutral();
     query<0>(result, handle.getIndex(), 0);
@@ -45,6 +112,31 @@ class FenwickTree : public types::StatelessEngineBase<NDims> {
     return result;
   }
 
+  /**
+   * @brief Returns the smallest index i such that query([0, i]) >= value, or N if there is none.
+   *
+   * Prefix results must be non-decreasing in i (e.g. sums of non-negative values). Descends the
+   * implicit tree by binary lifting in O(log N) instead of binary searching over query() in O(log^2 N).
+   */
+  size_t lowerBound(const T& value)
+    requires(NDims == 1)
+  {
+    size_t pos = 0;
+    T acc = op_.neutral();
+
+    // pos is the number of elements whose combination acc is still less than value
+    for (size_t step = std::bit_floor(dims_[0]); step > 0; step >>= 1) {
+      if (pos + step <= dims_[0]) {
+        T next = op_(acc, storage_[pos + step - 1]);
+        if (next < value) {
+          pos += step;
+          acc = next;
+        }
+      }
+    }
+    return pos;
+  }
+
  private:
   template <size_t I>
   void query(T& result, const types::Index<NDims>& qr, size_t index) {
@@ -86,18 +178,30 @@ class FenwickTree : public types::StatelessEngineBase<NDims> {
     }
   }
 
+  size_t linearIndex(const types::Index<NDims>& index) const noexcept {
+    size_t result = 0;
+    for (size_t dim = 0; dim < NDims; ++dim) {
+      result += index[dim] * strides_[dim];
+    }
+    return result;
+  }
+
   template <size_t I, utility::NDView<T, NDims> NDView>
-  void init(const NDView& a, types::Index<NDims>& idxs) {
+  void init(const NDView& a, types::Index<NDims>& idxs, size_t index) {
     for (size_t i = 0; i < dims_[I]; ++i) {
       idxs[I] = i;
       if constexpr (I == NDims - 1) {
-        update(idxs, a.at(idxs));
+        op_.update(storage_[index + i], a.at(idxs));
       } else {
-        init<I + 1>(a, idxs);
+        init<I + 1>(a, idxs, index + i * strides_[I]);
       }
     }
   }
 
+  void build(std::vector<T>& storage) {
+    detail::buildLinear(storage, dims_, strides_, [this](T& parent, const T& child) { op_.update(parent, child); });
+  }
+
   void initDims(const types::Index<NDims>& d) {
     std::copy(d.begin(), d.end(), dims_.begin());
     size_t stride = 1;
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/fenwick_tree/fenwick_tree.h"
+#include "algo/utility/nd_container.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace algo::fwt {
+
+/**
+ * @brief Fenwick tree with range additions and range sum queries.
+ *
+ * A range addition is stored as 2^NDims point additions to the corners of the range in the
+ * difference array D. The prefix sum up to x is then
+ *   sum over p <= x of D(p) * prod_k (x_k + 1 - p_k),
+ * and expanding the product splits it into 2^NDims sums of D(p) * prod_{k in S} p_k over the
+ * subsets S of dimensions. Each of them is kept in its own Fenwick tree. The trees are interleaved,
+ * so that updates and queries walk the indices only once.
+ *
+ * Both operations visit 2^NDims corners, and each of them walks O(log^NDims N) cells of all 2^NDims
+ * trees, hence they take O(4^NDims * log^NDims N) time.
+ */
+template <typename T, size_t NDims = 1>
+class RangeFenwickTree : public types::StatelessEngineBase<NDims> {
+  static constexpr size_t kTrees = size_t(1) << NDims;
+  using Cell = std::array<T, kTrees>;
+
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<NDims>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<NDims>::RangeQueryHandle;
+
+  explicit RangeFenwickTree(const types::Index<NDims>& dims) {
+    initDims(dims);
+  }
+
+  explicit RangeFenwickTree(utility::NDView<T, NDims> auto view) {
+    types::Index<NDims> d;
+    view.getDimensions(d);
+    initDims(d);
+    init<0>(view, d, 0);
+    build();
+  }
+
+  /**
+   * @brief Adds value to the element.
+   */
+  void update(QueryHandle& handle, const T& value) {
+    auto& index = handle.getIndex();
+    types::Range<NDims> range{index, index};
+    updateRange(range, value);
+  }
+
+  /**
+   * @brief Adds value to all elements of the range.
+   */
+  void updateRange(RangeQueryHandle& handle, const T& value) {
+    auto& [ul, ur] = handle.getRange();
+    types::Index<NDims> corner;
+
+    for (size_t mask = 0; mask < kTrees; ++mask) {
+      bool inside = true;
+      for (size_t dim = 0; dim < NDims; ++dim) {
+        corner[dim] = (mask >> dim) & 1 ? ur[dim] + 1 : ul[dim];
+        inside &= corner[dim] < dims_[dim];
+      }
+      if (inside) {
+        add(corner, std::popcount(mask) % 2 ? -value : value);
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the sum of elements in [0, index].
+   */
+  T query(QueryHandle& handle) {
+    return prefix(handle.getIndex());
+  }
+
+  T query(RangeQueryHandle& handle) {
+    auto& [ql, qr] = handle.getRange();
+    types::Index<NDims> corner;
+    T result = T(0);
+
+    for (size_t mask = 0; mask < kTrees; ++mask) {
+      bool empty = false;
+      for (size_t dim = 0; dim < NDims; ++dim) {
+        empty |= (mask >> dim) & 1 && ql[dim] == 0;
+        corner[dim] = (mask >> dim) & 1 ? ql[dim] - 1 : qr[dim];
+      }
+      if (!empty) {
+        T x = prefix(corner);
+        result += std::popcount(mask) % 2 ? -x : x;
+      }
+    }
+    return result;
+  }
+
+ private:
+  // Adds value to D(p)
+  void add(const types::Index<NDims>& p, const T& value) {
+    Cell delta;
+    for (size_t set = 0; set < kTrees; ++set) {
+      delta[set] = value;
+      for (size_t dim = 0; dim < NDims; ++dim) {
+        delta[set] *= (set >> dim) & 1 ? T(p[dim]) : T(1);
+      }
+    }
+    add<0>(p, 0, delta);
+  }
+
+  template <size_t I>
+  void add(const types::Index<NDims>& p, size_t index, const Cell& delta) {
+    for (auto i = p[I]; i < dims_[I]; i = (i | (i + 1))) {
+      if constexpr (I == NDims - 1) {
+        auto& cell = storage_[index + i];
+        for (size_t set = 0; set < kTrees; ++set) {
+          cell[set] += delta[set];
+        }
+      } else {
+        add<I + 1>(p, index + i * strides_[I], delta);
+      }
+    }
+  }
+
+  T prefix(const types::Index<NDims>& x) {
+    Cell sums{};
+    prefix<0>(sums, x, 0);
+
+    T result = T(0);
+    for (size_t set = 0; set < kTrees; ++set) {
+      T term = sums[set];
+      for (size_t dim = 0; dim < NDims; ++dim) {
+        term *= (set >> dim) & 1 ? T(1) : T(x[dim] + 1);
+      }
+      result += std::popcount(set) % 2 ? -term : term;
+    }
+    return result;
+  }
+
+  template <size_t I>
+  void prefix(Cell& sums, const types::Index<NDims>& x, size_t index) {
+    for (int64_t i = x[I]; i >= 0; i = (i & (i + 1)) - 1) {
+      if constexpr (I == NDims - 1) {
+        const auto& cell = storage_[index + i];
+        for (size_t set = 0; set < kTrees; ++set) {
+          sums[set] += cell[set];
+        }
+      } else {
+        prefix<I + 1>(sums, x, index + i * strides_[I]);
+      }
+    }
+  }
+
+  template <size_t I, utility::NDView<T, NDims> NDView>
+  void init(const NDView& a, types::Index<NDims>& idxs, size_t index) {
+    for (size_t i = 0; i < dims_[I]; ++i) {
+      idxs[I] = i;
+      if constexpr (I == NDims - 1) {
+        storage_[index + i][0] = a.at(idxs);
+      } else {
+        init<I + 1>(a, idxs, index + i * strides_[I]);
+      }
+    }
+  }
+
+  /**
+   * @brief Turns the stored values into the trees in O(2^NDims * N): takes the difference array
+   * along every dimension, fills in the products of coordinates and builds the trees in linear time
+   * (see detail::buildLinear).
+   */
+  void build() {
+    for (size_t dim = 0; dim < NDims; ++dim) {
+      size_t n = dims_[dim];
+      size_t stride = strides_[dim];
+
+      for (size_t outer = 0; outer < storage_.size(); outer += n * stride) {
+        for (size_t i = n; i-- > 1;) {
+          for (size_t j = 0; j < stride; ++j) {
+            storage_[outer + i * stride + j][0] -= storage_[outer + (i - 1) * stride + j][0];
+          }
+        }
+      }
+    }
+
+    types::Index<NDims> p{};
+    for (size_t index = 0; index < storage_.size(); ++index) {
+      for (size_t dim = 0, rest = index; dim < NDims; ++dim) {
+        p[dim] = rest / strides_[dim];
+        rest %= strides_[dim];
+      }
+
+      auto& cell = storage_[index];
+      for (size_t set = 1; set < kTrees; ++set) {
+        cell[set] = cell[0];
+        for (size_t dim = 0; dim < NDims; ++dim) {
+          cell[set] *= (set >> dim) & 1 ? T(p[dim]) : T(1);
+        }
+      }
+    }
+
+    detail::buildLinear(storage_, dims_, strides_, [](Cell& parent, const Cell& child) {
+      for (size_t set = 0; set < kTrees; ++set) {
+        parent[set] += child[set];
+      }
+    });
+  }
+
+  void initDims(const types::Index<NDims>& d) {
+    std::copy(d.begin(), d.end(), dims_.begin());
+    size_t stride = 1;
+    for (size_t dim = NDims; dim-- > 0;) {
+      strides_[dim] = stride;
+      stride *= dims_[dim];
+    }
+    storage_.assign(stride, Cell{});
+  }
+
+  types::Index<NDims> dims_;
+  types::Index<NDims> strides_;
+  std::vector<Cell> storage_;
+};
+
+}  // namespace algo::fwt
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "algo/kdtree/kdtree.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace algo::kdtree {
+
+/**
+ * @brief k-d tree with insertions and deletions, kept balanced by partial rebuilding (scapegoat tree).
+ *
+ * Nodes live in a single vector and refer to their children by index. A node at depth h splits by dimension
+ * h mod Dims, its left subtree holds points not greater along it and the right one points not less.
+ *
+ * Inserted points become leaves. Whenever a subtree on the path of an insertion has a child with more than
+ * kAlpha of its nodes, the topmost such subtree is rebuilt perfectly balanced from its points. Erased points are
+ * only marked as deleted and still split the space, until more than half of all nodes are deleted and the
+ * whole tree is rebuilt. Both updates take amortized O(log N) time, queries behave like those of KDTree.
+ */
+template <typename PointType, size_t Dims, typename DistanceBinaryFunctor = EuclideanDistance<PointType>>
+class DynamicKDTree {
+  using DistanceType = typename DistanceBinaryFunctor::DistanceType;
+  using KNNSearchQueue = detail::BoundedPriorityQueue<std::pair<DistanceType, const PointType*>>;
+
+  static constexpr size_t kNull = std::numeric_limits<size_t>::max();
+
+  struct Node {
+    PointType point;
+    std::array<size_t, 2> children{kNull, kNull};
+    size_t size = 1;  // Nodes in the subtree, including deleted ones
+    size_t alive = 1;  // Points in the subtree that are not deleted
+    bool deleted = false;
+  };
+
+ public:
+  using DistanceFunctor = DistanceBinaryFunctor;
+
+  DynamicKDTree() = default;
+
+  explicit DynamicKDTree(std::vector<PointType> points) {
+    root_ = buildTree(points.begin(), points.end(), 0);
+    rebuilt_size_ = points.size();
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return root_ == kNull ? 0 : nodes_[root_].alive;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  void insert(const PointType& point) {
+    size_t node = allocate(point);
+    if (root_ == kNull) {
+      root_ = node;
+      updated();
+      return;
+    }
+
+    // The topmost unbalanced subtree on the path and the link to it
+    size_t* scapegoat = nullptr;
+    size_t scapegoat_depth = 0;
+
+    path_.clear();
+    size_t* link = &root_;
+    while (*link != kNull) {
+      const size_t depth = path_.size();
+      path_.push_back(*link);
+
+      Node& v = nodes_[*link];
+      ++v.size;
+      ++v.alive;
+
+      const size_t direction = closestDirection(point, v.point, depth % Dims);
+      const size_t child = v.children[direction];
+      if (scapegoat == nullptr && child != kNull && !isBalanced(nodes_[child].size + 1, v.size)) {
+        scapegoat = link;
+        scapegoat_depth = depth;
+      }
+
+      link = &v.children[direction];
+    }
+    *link = node;
+
+    if (scapegoat != nullptr) {
+      // The deleted nodes of the subtree are dropped, the ancestors lose them too
+      const size_t removed = rebuild(*scapegoat, scapegoat_depth);
+      for (size_t depth = 0; depth < scapegoat_depth; ++depth) {
+        nodes_[path_[depth]].size -= removed;
+      }
+    }
+    updated();
+  }
+
+  /**
+   * @brief Erases one occurrence of the point. Returns false if there is no such point.
+   */
+  bool erase(const PointType& point) {
+    if (!eraseRecursive(root_, 0, point)) {
+      return false;
+    }
+    if (2 * nodes_[root_].alive < nodes_[root_].size) {
+      rebuild(root_, 0);
+    } else {
+      updated();
+    }
+    return true;
+  }
+
+  const PointType& nnSearch(const PointType& q) const {
+    assert(!empty() && !!"kdtree is empty");
+    DistanceType dist = DistanceBinaryFunctor::kMaxValue;
+    const PointType* point = nullptr;
+
+    nnSearchRecursive(root_, 0, q, dist, point);
+    return *point;
+  }
+
+  std::vector<PointType> knnSearch(const PointType& q, size_t max_count) const {
+    if (max_count == 0) {
+      return {};
+    }
+    assert(!empty() && !!"kdtree is empty");
+
+    KNNSearchQueue queue(max_count);
+    knnSearchRecursive(root_, 0, q, queue);
+
+    std::vector<PointType> result;
+    result.reserve(queue.size());
+
+    for (auto [_, point] : std::move(queue).collect()) {
+      result.push_back(*point);
+    }
+
+    return result;
+  }
+
+  std::vector<PointType> radiusSearch(const PointType& q, uint64_t radius) const {
+    radius *= radius;
+    std::vector<PointType> result;
+    radiusSearchRecursive(root_, 0, q, radius, result);
+    return result;
+  }
+
+ private:
+  static constexpr size_t kLeftChild = 0;
+  static constexpr size_t kRightChild = 1;
+
+  // The maximal fraction of the nodes of a subtree in one of its children
+  static constexpr double kAlpha = 0.7;
+  // Subtrees of at most that many nodes are never rebuilt
+  static constexpr size_t kMinUnbalancedSize = 8;
+
+  bool eraseRecursive(size_t v, size_t depth, const PointType& point) {
+    if (v == kNull || nodes_[v].alive == 0) {
+      return false;
+    }
+
+    Node& node = nodes_[v];
+    const size_t dim = depth % Dims;
+    bool erased = false;
+
+    if (!node.deleted && node.point == point) {
+      node.deleted = true;
+      erased = true;
+    } else {
+      // Points equal to the node along dim may be in both subtrees
+      erased = (point[dim] <= node.point[dim] && eraseRecursive(node.children[kLeftChild], depth + 1, point)) ||
+               (point[dim] >= node.point[dim] && eraseRecursive(node.children[kRightChild], depth + 1, point));
+    }
+
+    if (erased) {
+      --nodes_[v].alive;
+    }
+    return erased;
+  }
+
+  void nnSearchRecursive(
+      size_t v, size_t depth, const PointType& q, DistanceType& min_dist, const PointType*& point) const {
+    if (v == kNull || nodes_[v].alive == 0) {
+      return;
+    }
+
+    const Node& node = nodes_[v];
+    const auto& curr = node.point;
+    const size_t dim = depth % Dims;
+
+    if (!node.deleted) {
+      const auto distance = distance_(q, curr);
+      if (distance < min_dist) {
+        min_dist = distance;
+        point = &curr;
+      }
+    }
+
+    const size_t direction = closestDirection(q, curr, dim);
+    nnSearchRecursive(node.children[direction], depth + 1, q, min_dist, point);
+
+    if (distance_.axisDistance(q, curr, dim) < min_dist) {
+      nnSearchRecursive(node.children[1 - direction], depth + 1, q, min_dist, point);
+    }
+  }
+
+  void knnSearchRecursive(size_t v, size_t depth, const PointType& q, KNNSearchQueue& queue) const {
+    if (v == kNull || nodes_[v].alive == 0) {
+      return;
+    }
+
+    const Node& node = nodes_[v];
+    const auto& curr = node.point;
+    const size_t dim = depth % Dims;
+
+    if (!node.deleted) {
+      const auto distance = distance_(q, curr);
+      if (queue.size() < queue.maxSize() || distance < queue.top().first) {
+        queue.emplace(distance, &curr);
+      }
+    }
+
+    const size_t direction = closestDirection(q, curr, dim);
+    knnSearchRecursive(node.children[direction], depth + 1, q, queue);
+
+    if (queue.size() < queue.maxSize() || distance_.axisDistance(q, curr, dim) < queue.top().first) {
+      knnSearchRecursive(node.children[1 - direction], depth + 1, q, queue);
+    }
+  }
+
+  void radiusSearchRecursive(
+      size_t v, size_t depth, const PointType& q, uint64_t radius, std::vector<PointType>& output) const {
+    if (v == kNull || nodes_[v].alive == 0) {
+      return;
+    }
+
+    const Node& node = nodes_[v];
+    const auto& curr = node.point;
+    const size_t dim = depth % Dims;
+
+    if (!node.deleted && distance_(q, curr) < radius) {
+      output.push_back(curr);
+    }
+
+    const size_t direction = closestDirection(q, curr, dim);
+    radiusSearchRecursive(node.children[direction], depth + 1, q, radius, output);
+
+    if (distance_.axisDistance(q, curr, dim) < radius) {
+      radiusSearchRecursive(node.children[1 - direction], depth + 1, q, radius, output);
+    }
+  }
+
+  /**
+   * @brief Replaces the subtree v at the depth with a balanced tree of its points that are not deleted.
+   * Returns the number of the dropped deleted nodes.
+   */
+  size_t rebuild(size_t& v, size_t depth) {
+    const size_t size = nodes_[v].size;
+    scratch_.clear();
+    collect(v);
+    if (&v == &root_) {
+      // Lays out the whole tree in preorder again
+      nodes_.clear();
+      free_.clear();
+      updates_ = 0;
+      rebuilt_size_ = scratch_.size();
+    }
+    // Otherwise reuses the freed nodes only, so that v stays valid
+    v = buildTree(scratch_.begin(), scratch_.end(), depth);
+    return size - scratch_.size();
+  }
+
+  // Moves the points that are not deleted to scratch_ and frees all nodes of the subtree
+  void collect(size_t v) {
+    if (v == kNull) {
+      return;
+    }
+    if (!nodes_[v].deleted) {
+      scratch_.push_back(nodes_[v].point);
+    }
+    collect(nodes_[v].children[kLeftChild]);
+    collect(nodes_[v].children[kRightChild]);
+    free_.push_back(v);
+  }
+
+  template <std::random_access_iterator It>
+  size_t buildTree(It begin, It end, size_t depth) {
+    const size_t size = std::distance(begin, end);
+    if (size == 0) {
+      return kNull;
+    }
+
+    const size_t dim = depth % Dims;
+    auto it = begin + size / 2;
+    std::nth_element(begin, it, end, [dim](const auto& p1, const auto& p2) { return p1[dim] < p2[dim]; });
+
+    const size_t v = allocate(*it);
+    const size_t left = buildTree(begin, it, depth + 1);
+    const size_t right = buildTree(it + 1, end, depth + 1);
+
+    Node& node = nodes_[v];
+    node.children = {left, right};
+    node.size = node.alive = size;
+    return v;
+  }
+
+  /**
+   * @brief Rebuilds the whole tree after as many updates as it had points after the previous full rebuild.
+   * The partial rebuilds keep it balanced, but reuse scattered nodes, and the inserted points split the space
+   * worse than medians. Takes amortized O(log N) per update.
+   */
+  void updated() {
+    if (++updates_ > rebuilt_size_) {
+      rebuild(root_, 0);
+    }
+  }
+
+  size_t allocate(const PointType& point) {
+    if (free_.empty()) {
+      nodes_.push_back(Node{.point = point});
+      return nodes_.size() - 1;
+    }
+    size_t v = free_.back();
+    free_.pop_back();
+    nodes_[v] = Node{.point = point};
+    return v;
+  }
+
+  static bool isBalanced(size_t child_size, size_t size) noexcept {
+    return size <= kMinUnbalancedSize || static_cast<double>(child_size) <= kAlpha * static_cast<double>(size);
+  }
+
+  static size_t closestDirection(const PointType& query, const PointType& current, size_t dim) noexcept {
+    return query[dim] <= current[dim] ? kLeftChild : kRightChild;
+  }
+
+  [[no_unique_address]] DistanceBinaryFunctor distance_;
+  std::vector<Node> nodes_;
+  std::vector<size_t> free_;
+  std::vector<PointType> scratch_;
+  std::vector<size_t> path_;
+  size_t root_ = kNull;
+  size_t updates_ = 0;  // Since the last full rebuild
+  size_t rebuilt_size_ = 0;  // Points after the last full rebuild
+};
+
+}  // namespace algo::kdtree
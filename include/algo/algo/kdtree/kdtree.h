@@ -2,12 +2,22 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
-#include <memory>
 #include <numeric>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace algo::kdtree {
 
 namespace detail {
@@ -33,6 +43,17 @@ class BoundedPriorityQueue {
   std::vector<T> collect() && {
     return std::move(container_);
   }
+
+  /**
+   * @brief Sorts the elements in ascending order, after which the queue may only be cleared.
+   */
+  const std::vector<T>& sort() {
+    std::sort_heap(container_.begin(), container_.end(), comp_);
+    return container_;
+  }
+  void clear() noexcept {
+    container_.clear();
+  }
   const T& top() {
     return container_.front();
   }
@@ -49,6 +70,29 @@ class BoundedPriorityQueue {
   std::vector<T> container_;
 };
 
+#if defined(__AVX2__)
+
+/**
+ * @brief Squared distances from q to the points of the columns, four at a time in 64-bit lanes.
+ * Returns the number of points processed, a multiple of 4.
+ */
+inline size_t squaredDistancesAvx2(
+    const int32_t* q, size_t dims, const int32_t* column, size_t stride, size_t count, uint64_t* out) noexcept {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t dim = 0; dim < dims; ++dim) {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + dim * stride + i));
+      __m256i diff = _mm256_sub_epi64(_mm256_cvtepi32_epi64(x), _mm256_set1_epi64x(q[dim]));
+      acc = _mm256_add_epi64(acc, _mm256_mul_epi32(diff, diff));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), acc);
+  }
+  return i;
+}
+
+#endif
+
 }  // namespace detail
 
 template <typename PointType>
@@ -66,30 +110,91 @@ struct EuclideanDistance {
     const uint64_t dist = a[dim] <= b[dim] ? b[dim] - a[dim] : a[dim] - b[dim];
     return dist * dist;
   }
+
+  /**
+   * @brief Distances from q to count points of a leaf stored by columns: the coordinate dim of the i-th
+   * point is column[dim * stride + i]. Optional, KDTree falls back to operator() without it.
+   */
+  template <typename Coordinate>
+  void leafDistances(const PointType& q, const Coordinate* column, size_t stride, size_t count, uint64_t* out) const {
+    const size_t dims = std::distance(q.begin(), q.end());
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<Coordinate, int32_t>) {
+      i = detail::squaredDistancesAvx2(&*q.begin(), dims, column, stride, count, out);
+    }
+#endif
+
+    for (; i < count; ++i) {
+      uint64_t distance = 0;
+      for (size_t dim = 0; dim < dims; ++dim) {
+        auto x = column[dim * stride + i];
+        auto y = q[dim];
+        distance += static_cast<uint64_t>((x - y) * (x - y));
+      }
+      out[i] = distance;
+    }
+  }
 };
 
-template <typename PointType, size_t Dims, typename DistanceBinaryFunctor = EuclideanDistance<PointType>>
+/**
+ * @brief Static k-d tree stored as a single array of points in preorder, without child pointers.
+ *
+ * A subtree occupies a range [b, e): its median along the splitting dimension is at b, followed by
+ * the left subtree [b + 1, m + 1) and the right subtree [m + 1, e), where m = b + (e - b) / 2.
+ * The left child of a node is the next element of the array, so descents mostly read memory sequentially.
+ *
+ * Subtrees of at most LeafSize points are not split further and are scanned as a whole. If the distance
+ * functor provides leafDistances (see EuclideanDistance), the coordinates are also kept by columns,
+ * so that the whole leaf is evaluated in one vectorized call.
+ */
+template <
+    typename PointType, size_t Dims, typename DistanceBinaryFunctor = EuclideanDistance<PointType>,
+    size_t LeafSize = 32>
 class KDTree {
-  struct Node {
-    PointType point;
-    std::array<std::unique_ptr<Node>, 2> children{};
-  };
+  static_assert(LeafSize > 0);
 
   using DistanceType = typename DistanceBinaryFunctor::DistanceType;
-  using KNNSearchQueue = detail::BoundedPriorityQueue<std::pair<DistanceType, const Node*>>;
+  using KNNSearchQueue = detail::BoundedPriorityQueue<std::pair<DistanceType, const PointType*>>;
+  using Coordinate = std::remove_cvref_t<decltype(std::declval<const PointType&>()[0])>;
+
+  static constexpr bool kHasLeafDistances = requires(
+      const DistanceBinaryFunctor& f, const PointType& q, const Coordinate* column, DistanceType* out) {
+    f.leafDistances(q, column, size_t{}, size_t{}, out);
+  };
 
  public:
   using DistanceFunctor = DistanceBinaryFunctor;
 
-  explicit KDTree(std::vector<PointType>& points)  //
-      : root_{buildTree(points.begin(), points.end(), 0)} {}
+  explicit KDTree(std::vector<PointType> points) : KDTree(std::move(points), 1) {}
+
+  /**
+   * @brief Builds the tree using up to num_threads threads.
+   *
+   * The two subtrees of a node occupy disjoint ranges of the points, so they are built concurrently while
+   * they have at least kMinParallelBuildSize points. The result is the same as that of the sequential build.
+   */
+  KDTree(std::vector<PointType> points, size_t num_threads)  //
+      : points_{std::move(points)} {
+    buildTreeParallel({0, points_.size()}, 0, std::max<size_t>(num_threads, 1));
+
+    if constexpr (kHasLeafDistances) {
+      columns_.resize(Dims * points_.size());
+      for (size_t i = 0; i < points_.size(); ++i) {
+        for (size_t dim = 0; dim < Dims; ++dim) {
+          columns_[dim * points_.size() + i] = points_[i][dim];
+        }
+      }
+    }
+  }
 
   const PointType& nnSearch(const PointType& q) const {
-    assert(root_ && !!"kdtree is empty");
+    assert(!points_.empty() && !!"kdtree is empty");
     DistanceType dist = DistanceBinaryFunctor::kMaxValue;
     const PointType* point = nullptr;
 
-    nnSearchRecursive(root_.get(), 0, q, dist, point);
+    nnSearchRecursive({0, points_.size()}, 0, q, dist, point);
     return *point;
   }
 
@@ -97,43 +202,97 @@ class KDTree {
     if (max_count == 0) {
       return {};
     }
-    assert(root_ && !!"kdtree is empty");
+    assert(!points_.empty() && !!"kdtree is empty");
 
     KNNSearchQueue queue(max_count);
-    knnSearchRecursive(root_.get(), 0, q, queue);
+    knnSearchRecursive({0, points_.size()}, 0, q, queue);
 
     std::vector<PointType> result;
     result.reserve(queue.size());
 
-    for (auto [_, node] : std::move(queue).collect()) {
-      result.push_back(node->point);
+    for (auto [_, point] : std::move(queue).collect()) {
+      result.push_back(*point);
     }
 
     return result;
   }
 
+  /**
+   * @brief Finds the k nearest points for each of the queries using up to num_threads threads.
+   *
+   * The neighbours of queries[i] are written to output[i * k, (i + 1) * k) in order of increasing distance,
+   * so output must hold queries.size() * k points, and the tree must have at least k points.
+   * Every thread reuses a single search queue for all of its queries, which are taken in chunks.
+   */
+  void knnSearchBatch(
+      std::span<const PointType> queries, size_t k, std::span<PointType> output, size_t num_threads = 1) const {
+    static constexpr size_t kChunk = 64;
+
+    assert(k <= points_.size() && !!"not enough points in the kdtree");
+    assert(output.size() >= queries.size() * k && !!"output is too small");
+    if (k == 0 || queries.empty()) {
+      return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+      KNNSearchQueue queue(k);
+      for (size_t first; (first = next.fetch_add(kChunk, std::memory_order_relaxed)) < queries.size();) {
+        for (size_t i = first; i < std::min(first + kChunk, queries.size()); ++i) {
+          knnSearchRecursive({0, points_.size()}, 0, queries[i], queue);
+          const auto& sorted = queue.sort();
+          std::transform(
+              sorted.begin(), sorted.end(), output.begin() + i * k, [](const auto& item) { return *item.second; });
+          queue.clear();
+        }
+      }
+    };
+
+    num_threads = std::clamp<size_t>(num_threads, 1, (queries.size() + kChunk - 1) / kChunk);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < num_threads; ++t) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
   std::vector<PointType> radiusSearch(const PointType& q, uint64_t radius) const {
-    if (!root_) {
+    if (points_.empty()) {
       return {};
     }
 
     radius *= radius;
     std::vector<PointType> result;
-    radiusSearchRecursive(root_.get(), 0, q, radius, result);
+    radiusSearchRecursive({0, points_.size()}, 0, q, radius, result);
     return result;
   }
 
  private:
+  // Range [first, second) of the points array occupied by a subtree
+  using Subtree = std::pair<size_t, size_t>;
+
   static constexpr size_t kLeftChild = 0;
   static constexpr size_t kRightChild = 1;
+  static constexpr size_t kMinParallelBuildSize = 1ULL << 14;
 
   void nnSearchRecursive(
-      const Node* v, size_t dim, const PointType& q, DistanceType& min_dist, const PointType*& point) const {
-    if (v == nullptr) {
+      Subtree v, size_t dim, const PointType& q, DistanceType& min_dist, const PointType*& point) const {
+    if (isLeaf(v)) {
+      std::array<DistanceType, LeafSize> distances;
+      leafDistances(v, q, distances.data());
+      for (size_t i = 0; i < v.second - v.first; ++i) {
+        if (distances[i] < min_dist) {
+          min_dist = distances[i];
+          point = &points_[v.first + i];
+        }
+      }
       return;
     }
 
-    const auto& curr = v->point;
+    const auto& curr = points_[v.first];
     const auto distance = distance_(q, curr);
 
     if (distance < min_dist) {
@@ -141,78 +300,129 @@ class KDTree {
       point = &curr;
     }
 
+    const auto children = childrenOf(v);
     const size_t direction = closestDirection(q, curr, dim);
     const size_t next_dim = nextDimension(dim);
-    nnSearchRecursive(v->children[direction].get(), next_dim, q, min_dist, point);
+    nnSearchRecursive(children[direction], next_dim, q, min_dist, point);
 
     if (distance_.axisDistance(q, curr, dim) < min_dist) {
-      nnSearchRecursive(v->children[1 - direction].get(), next_dim, q, min_dist, point);
+      nnSearchRecursive(children[1 - direction], next_dim, q, min_dist, point);
     }
   }
 
-  void knnSearchRecursive(const Node* v, size_t dim, const PointType& q, KNNSearchQueue& queue) const {
-    if (v == nullptr) {
+  void knnSearchRecursive(Subtree v, size_t dim, const PointType& q, KNNSearchQueue& queue) const {
+    if (isLeaf(v)) {
+      std::array<DistanceType, LeafSize> distances;
+      leafDistances(v, q, distances.data());
+      for (size_t i = 0; i < v.second - v.first; ++i) {
+        if (queue.size() < queue.maxSize() || distances[i] < queue.top().first) {
+          queue.emplace(distances[i], &points_[v.first + i]);
+        }
+      }
       return;
     }
 
-    const auto& curr = v->point;
+    const auto& curr = points_[v.first];
     const auto distance = distance_(q, curr);
-    queue.emplace(distance, v);
+    queue.emplace(distance, &curr);
 
+    const auto children = childrenOf(v);
     const size_t direction = closestDirection(q, curr, dim);
     const size_t next_dim = nextDimension(dim);
-    knnSearchRecursive(v->children[direction].get(), next_dim, q, queue);
+    knnSearchRecursive(children[direction], next_dim, q, queue);
 
     if (queue.size() < queue.maxSize() || distance_.axisDistance(q, curr, dim) < queue.top().first) {
-      knnSearchRecursive(v->children[1 - direction].get(), next_dim, q, queue);
+      knnSearchRecursive(children[1 - direction], next_dim, q, queue);
     }
   }
 
   void radiusSearchRecursive(
-      const Node* v, size_t dim, const PointType& q, uint64_t radius, std::vector<PointType>& output) const {
-    if (!v) {
+      Subtree v, size_t dim, const PointType& q, uint64_t radius, std::vector<PointType>& output) const {
+    if (isLeaf(v)) {
+      std::array<DistanceType, LeafSize> distances;
+      leafDistances(v, q, distances.data());
+      for (size_t i = 0; i < v.second - v.first; ++i) {
+        if (distances[i] < radius) {
+          output.push_back(points_[v.first + i]);
+        }
+      }
       return;
     }
 
-    const auto& curr = v->point;
+    const auto& curr = points_[v.first];
     const auto distance = distance_(q, curr);
 
     if (distance < radius) {
       output.push_back(curr);
     }
 
+    const auto children = childrenOf(v);
     const size_t direction = closestDirection(q, curr, dim);
     const size_t next_dim = nextDimension(dim);
-    radiusSearchRecursive(v->children[direction].get(), next_dim, q, radius, output);
+    radiusSearchRecursive(children[direction], next_dim, q, radius, output);
 
     if (distance_.axisDistance(q, curr, dim) < radius) {
-      radiusSearchRecursive(v->children[1 - direction].get(), next_dim, q, radius, output);
+      radiusSearchRecursive(children[1 - direction], next_dim, q, radius, output);
     }
   }
 
-  template <std::random_access_iterator It>
-  static std::unique_ptr<Node> buildTree(It begin, It end, size_t dim) {
-    const size_t size = std::distance(begin, end);
+  void buildTree(Subtree v, size_t dim) {
+    if (isLeaf(v)) {
+      return;
+    }
 
-    if (size == 0) {
-      return {};
+    splitMedian(v, dim);
+    const auto children = childrenOf(v);
+    const size_t next_dim = nextDimension(dim);
+    buildTree(children[kLeftChild], next_dim);
+    buildTree(children[kRightChild], next_dim);
+  }
+
+  void buildTreeParallel(Subtree v, size_t dim, size_t num_threads) {
+    if (num_threads == 1 || v.second - v.first < kMinParallelBuildSize || isLeaf(v)) {
+      buildTree(v, dim);
+      return;
     }
-    if (size == 1) {
-      return std::unique_ptr<Node>(new Node{.point = *begin});
+
+    splitMedian(v, dim);
+    const auto children = childrenOf(v);
+    const size_t next_dim = nextDimension(dim);
+    std::thread worker([&, left = children[kLeftChild]] { buildTreeParallel(left, next_dim, num_threads / 2); });
+    buildTreeParallel(children[kRightChild], next_dim, num_threads - num_threads / 2);
+    worker.join();
+  }
+
+  // Moves the median along dim to the front of the subtree, followed by the smaller and then the greater points
+  void splitMedian(Subtree v, size_t dim) {
+    auto begin = points_.begin();
+    std::nth_element(
+        begin + v.first, begin + middle(v), begin + v.second,
+        [dim](const auto& p1, const auto& p2) { return p1[dim] < p2[dim]; });
+    std::iter_swap(begin + v.first, begin + middle(v));
+  }
+
+  static bool isLeaf(Subtree v) noexcept {
+    return v.second - v.first <= LeafSize;
+  }
+
+  void leafDistances(Subtree v, const PointType& q, DistanceType* out) const {
+    const size_t count = v.second - v.first;
+    if constexpr (kHasLeafDistances) {
+      distance_.leafDistances(q, columns_.data() + v.first, points_.size(), count, out);
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        out[i] = distance_(q, points_[v.first + i]);
+      }
     }
+  }
 
-    auto it = begin + size / 2;
-    std::nth_element(begin, it, end, [dim](const auto& p1, const auto& p2) { return p1[dim] < p2[dim]; });
+  static size_t middle(Subtree v) noexcept {
+    return v.first + (v.second - v.first) / 2;
+  }
 
-    const size_t next_dim = nextDimension(dim);
-    return std::unique_ptr<Node>(new Node{
-        .point = *it,
-        .children =
-            {
-                buildTree(begin, it, next_dim),
-                buildTree(it + 1, end, next_dim),
-            },
-    });
+  static std::array<Subtree, 2> childrenOf(Subtree v) noexcept {
+    const size_t m = middle(v);
+    return {Subtree{v.first + 1, m + 1}, Subtree{m + 1, v.second}};
   }
 
   static size_t nextDimension(size_t dim) noexcept {
@@ -224,7 +434,8 @@ class KDTree {
   }
 
   [[no_unique_address]] DistanceBinaryFunctor distance_;
-  std::unique_ptr<Node> root_{nullptr};
+  std::vector<PointType> points_;
+  std::vector<Coordinate> columns_;
 };
 
-}  // namespace algo::kdtree
\ No newline at end of file
+}  // namespace algo::kdtree
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "algo/segment_tree/segment_tree.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace algo::sgt {
+
+/**
+ * @brief Range update for BeatsOp: x = min(x, value), x = max(x, value) or x += value.
+ */
+template <typename T>
+struct BeatsUpdate {
+  enum class Kind { kChmin, kChmax, kAdd };
+
+  /**
+   * @brief Applies the update to a single element.
+   */
+  void operator()(T& x) const noexcept {
+    switch (kind) {
+      case Kind::kChmin:
+        x = std::min(x, value);
+        break;
+      case Kind::kChmax:
+        x = std::max(x, value);
+        break;
+      case Kind::kAdd:
+        x += value;
+        break;
+    }
+  }
+
+  Kind kind;
+  T value;
+};
+
+/**
+ * @brief For the underlying segment:
+ *  - stores the sum of segment's values,
+ *  - stores the largest and the second largest values and the count of the largest ones,
+ *  - stores the smallest and the second smallest values and the count of the smallest ones,
+ *  - optionally stores the value added to all its elements.
+ *
+ * Converts to the sum of the segment.
+ */
+template <typename T>
+struct BeatsNode {
+  using value_type = T;
+
+  static constexpr T kLowest = std::numeric_limits<T>::lowest();
+  static constexpr T kHighest = std::numeric_limits<T>::max();
+
+  BeatsNode() = default;
+  BeatsNode(T x) : sum(x), max1(x), min1(x), max_count(1), min_count(1), size(1) {}
+
+  operator T() const noexcept {
+    return sum;
+  }
+
+  T sum = 0;
+  T max1 = kLowest;
+  T max2 = kLowest;
+  T min1 = kHighest;
+  T min2 = kHighest;
+  T added = 0;
+  size_t max_count = 0;
+  size_t min_count = 0;
+  size_t size = 0;
+};
+
+/**
+ * @brief Segment tree beats (Ji's driver tree): range chmin, chmax and add with range sum, min and max queries.
+ *
+ * A chmin update stops at the nodes whose maximum does not exceed the value (breakCondition) and is applied
+ * as a tag to the nodes whose second maximum is below it (tagCondition), since then only the maxima change.
+ * chmax is symmetric. The updates take amortized O(log^2 N) time. Only one-dimensional trees are supported.
+ */
+template <typename T>
+struct BeatsOp : public base_op<BeatsNode<T>, BeatsOp<T>> {
+  using Node = BeatsNode<T>;
+  using Update = BeatsUpdate<T>;
+  using Kind = typename Update::Kind;
+
+  Node neutral() const noexcept {
+    return Node();
+  }
+  Node init() const noexcept {
+    return Node(0);
+  }
+
+  Node combine(const Node& left, const Node& right) const noexcept {
+    Node node;
+    node.sum = left.sum + right.sum;
+    node.size = left.size + right.size;
+
+    if (left.max1 == right.max1) {
+      node.max1 = left.max1;
+      node.max2 = std::max(left.max2, right.max2);
+      node.max_count = left.max_count + right.max_count;
+    } else {
+      const Node& hi = left.max1 > right.max1 ? left : right;
+      const Node& lo = left.max1 > right.max1 ? right : left;
+      node.max1 = hi.max1;
+      node.max2 = std::max(hi.max2, lo.max1);
+      node.max_count = hi.max_count;
+    }
+
+    if (left.min1 == right.min1) {
+      node.min1 = left.min1;
+      node.min2 = std::min(left.min2, right.min2);
+      node.min_count = left.min_count + right.min_count;
+    } else {
+      const Node& lo = left.min1 < right.min1 ? left : right;
+      const Node& hi = left.min1 < right.min1 ? right : left;
+      node.min1 = lo.min1;
+      node.min2 = std::min(lo.min2, hi.min1);
+      node.min_count = lo.min_count;
+    }
+
+    return node;
+  }
+
+  void push(Node& root, Node& left, Node& right) const noexcept {
+    for (Node* child : {&left, &right}) {
+      if (root.added != 0) {
+        add(*child, root.added);
+      }
+      if (child->max1 > root.max1) {
+        chmin(*child, root.max1);
+      }
+      if (child->min1 < root.min1) {
+        chmax(*child, root.min1);
+      }
+    }
+    root.added = 0;
+  }
+
+  void updateLeaf(Node& node, T value) const noexcept {
+    node = Node(value);
+  }
+
+  bool breakCondition(const Node& node, const Update& update) const noexcept {
+    switch (update.kind) {
+      case Kind::kChmin:
+        return node.max1 <= update.value;
+      case Kind::kChmax:
+        return node.min1 >= update.value;
+      default:
+        return false;
+    }
+  }
+
+  bool tagCondition(const Node& node, const Update& update) const noexcept {
+    switch (update.kind) {
+      case Kind::kChmin:
+        return node.max2 < update.value;
+      case Kind::kChmax:
+        return node.min2 > update.value;
+      default:
+        return true;
+    }
+  }
+
+  void updateRange(Node& node, const Update& update) const noexcept {
+    switch (update.kind) {
+      case Kind::kChmin:
+        chmin(node, update.value);
+        break;
+      case Kind::kChmax:
+        chmax(node, update.value);
+        break;
+      case Kind::kAdd:
+        add(node, update.value);
+        break;
+    }
+  }
+
+ private:
+  // Requires max2 < value < max1
+  static void chmin(Node& node, T value) noexcept {
+    node.sum -= (node.max1 - value) * T(node.max_count);
+    if (node.min1 == node.max1) {
+      node.min1 = value;
+    } else if (node.min2 == node.max1) {
+      node.min2 = value;
+    }
+    node.max1 = value;
+  }
+
+  // Requires min1 < value < min2
+  static void chmax(Node& node, T value) noexcept {
+    node.sum += (value - node.min1) * T(node.min_count);
+    if (node.max1 == node.min1) {
+      node.max1 = value;
+    } else if (node.max2 == node.min1) {
+      node.max2 = value;
+    }
+    node.min1 = value;
+  }
+
+  static void add(Node& node, T value) noexcept {
+    node.sum += value * T(node.size);
+    node.max1 += value;
+    node.min1 += value;
+    if (node.max2 != Node::kLowest) {
+      node.max2 += value;
+    }
+    if (node.min2 != Node::kHighest) {
+      node.min2 += value;
+    }
+    node.added += value;
+  }
+};
+
+template <typename T>
+using BeatsSegmentTree = SegmentTree<BeatsNode<T>, BeatsOp<T>, 1>;
+
+}  // namespace algo::sgt
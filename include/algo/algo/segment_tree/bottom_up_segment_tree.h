@@ -0,0 +1,92 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/segment_tree/segment_tree.h"
+#include "algo/utility/nd_container.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace algo::sgt {
+
+/**
+ * @brief Non-recursive one-dimensional segment tree.
+ *
+ * Stores exactly 2N nodes: leaves occupy [N, 2N) and the parent of node v is v / 2.
+ * Queries and updates walk the tree bottom-up, without recursion and without any per-step bookkeeping.
+ *
+ * Node and Op requirements are the same as for SegmentTree (see base_op), except that range updates
+ * are not supported: Op::push and Op::updateRange are never called. Op::combine is not required to be
+ * commutative.
+ */
+template <typename Node, typename Op>
+class BottomUpSegmentTree : public types::StatelessEngineBase<1> {
+  using T = typename Node::value_type;
+
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<1>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<1>::RangeQueryHandle;
+
+  explicit BottomUpSegmentTree(const types::Index<1>& dims) {
+    initDims(dims);
+  }
+
+  explicit BottomUpSegmentTree(utility::NDView<T, 1> auto view) {
+    types::Index<1> d;
+    view.getDimensions(d);
+    initDims(d);
+
+    for (size_t i = 0; i < size_; ++i) {
+      op_.updateLeaf(storage_[size_ + i], view.at(i));
+    }
+    for (size_t v = size_; v-- > 1;) {
+      storage_[v] = op_.combine(storage_[2 * v], storage_[2 * v + 1]);
+    }
+  }
+
+  Node query(RangeQueryHandle& handle) {
+    auto& [ql, qr] = handle.getRange();
+    Node left = op_.neutral();
+    Node right = op_.neutral();
+
+    for (size_t l = ql[0] + size_, r = qr[0] + size_ + 1; l < r; l >>= 1, r >>= 1) {
+      if (l & 1) {
+        left = op_.combine(left, storage_[l++]);
+      }
+      if (r & 1) {
+        right = op_.combine(storage_[--r], right);
+      }
+    }
+
+    return op_.combine(left, right);
+  }
+
+  template <typename F>
+  void update(QueryHandle& handle, const F& func) {
+    size_t v = handle.getIndex()[0] + size_;
+    func(storage_[v]);
+
+    for (v >>= 1; v > 0; v >>= 1) {
+      storage_[v] = op_.combine(storage_[2 * v], storage_[2 * v + 1]);
+    }
+  }
+
+  void update(QueryHandle& handle, const T& value) {
+    update(handle, [&value](auto& x) { x = value; });
+  }
+
+ private:
+  void initDims(const types::Index<1>& d) {
+    size_ = d[0];
+    storage_.assign(2 * size_, op_.init());
+  }
+
+  [[no_unique_address]] Op op_;
+  size_t size_;
+  std::vector<Node> storage_;
+};
+
+template <typename T, typename Op>
+using SimpleBottomUpSegmentTree = BottomUpSegmentTree<simple_node<T>, simple_op<simple_node<T>, Op>>;
+
+}  // namespace algo::sgt
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace algo::sgt {
+
+/**
+ * @brief Segment tree shared between many reader threads and a single writer thread.
+ *
+ * Readers query an immutable published snapshot, so they never wait for each other or for the writer.
+ * The writer applies updates to a private copy of the tree and publishes it atomically with publish(),
+ * the updates are not visible to the readers until then.
+ *
+ * The tree is double-buffered: after publishing, the previous version becomes the writer's copy once
+ * its reader count drops to zero (RCU grace period), then the published updates are replayed on it.
+ * Hence every update is applied twice, and the writer may wait for slow readers on the first update
+ * after publish().
+ *
+ * Tree must provide a const query (e.g. SegmentTree, which is flushed before publishing).
+ */
+template <typename Tree>
+class ConcurrentSegmentTree {
+  struct Version {
+    template <typename... Args>
+    explicit Version(Args&&... args) : tree(std::forward<Args>(args)...) {}
+
+    Tree tree;
+    std::atomic<size_t> readers = 0;
+  };
+
+ public:
+  using QueryHandle = typename Tree::QueryHandle;
+  using RangeQueryHandle = typename Tree::RangeQueryHandle;
+
+  /**
+   * @brief Reference to a published version, the writer does not modify it until all its snapshots are released.
+   */
+  class Snapshot {
+   public:
+    Snapshot() = default;
+
+    Snapshot(const Snapshot& other) noexcept : version_(other.version_) {
+      if (version_ != nullptr) {
+        version_->readers.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    Snapshot(Snapshot&& other) noexcept : version_(std::exchange(other.version_, nullptr)) {}
+
+    Snapshot& operator=(Snapshot other) noexcept {
+      std::swap(version_, other.version_);
+      return *this;
+    }
+
+    ~Snapshot() {
+      reset();
+    }
+
+    void reset() noexcept {
+      if (version_ != nullptr) {
+        // Orders the reads of the tree before the writer observes the count
+        std::exchange(version_, nullptr)->readers.fetch_sub(1, std::memory_order_release);
+      }
+    }
+
+    const Tree& operator*() const noexcept {
+      return version_->tree;
+    }
+
+    const Tree* operator->() const noexcept {
+      return &version_->tree;
+    }
+
+    explicit operator bool() const noexcept {
+      return version_ != nullptr;
+    }
+
+   private:
+    explicit Snapshot(Version* version) noexcept : version_(version) {}
+
+    Version* version_ = nullptr;
+
+    friend class ConcurrentSegmentTree;
+  };
+
+  template <typename... Args>
+  explicit ConcurrentSegmentTree(Args&&... args)
+      : versions_{std::make_unique<Version>(std::forward<Args>(args)...)} {
+    versions_[1] = std::make_unique<Version>(versions_[0]->tree);
+    back_ = versions_[0].get();
+    published_.store(versions_[1].get());
+  }
+
+  // Reader's interface, may be called concurrently from any number of threads
+
+  [[nodiscard]] QueryHandle getQueryHandle() const noexcept {
+    return snapshot()->getQueryHandle();
+  }
+
+  [[nodiscard]] RangeQueryHandle getRangeQueryHandle() const noexcept {
+    return snapshot()->getRangeQueryHandle();
+  }
+
+  /**
+   * @brief Returns the last published version. Queries to the same snapshot are consistent with each other.
+   */
+  [[nodiscard]] Snapshot snapshot() const noexcept {
+    while (true) {
+      Version* version = published_.load();
+      version->readers.fetch_add(1);
+      // The writer may have taken the version back before it saw the reader, then it is published no more.
+      // Both sides use sequentially consistent operations, so at least one of them notices the other.
+      if (published_.load() == version) {
+        return Snapshot(version);
+      }
+      version->readers.fetch_sub(1);
+    }
+  }
+
+  auto query(RangeQueryHandle& handle) const {
+    return snapshot()->query(handle);
+  }
+
+  // Writer's interface, must be called from a single thread at a time
+
+  template <typename... Args>
+  void update(QueryHandle& handle, const Args&... args) {
+    apply([handle, args...](Tree& tree) mutable { tree.update(handle, args...); });
+  }
+
+  template <typename U>
+  void updateRange(RangeQueryHandle& handle, const U& value) {
+    apply([handle, value](Tree& tree) mutable { tree.updateRange(handle, value); });
+  }
+
+  /**
+   * @brief Atomically makes all updates applied since the last call visible to the readers.
+   */
+  void publish() {
+    catchUp();
+    if constexpr (requires { back_->tree.flush(); }) {
+      back_->tree.flush();
+    }
+
+    back_ = published_.exchange(back_);
+    replay_ = std::move(pending_);
+    pending_.clear();
+    behind_ = true;
+  }
+
+ private:
+  void apply(std::function<void(Tree&)> update) {
+    catchUp();
+    update(back_->tree);
+    pending_.push_back(std::move(update));
+  }
+
+  /**
+   * @brief Waits until the readers release the previous version and brings it up to date.
+   */
+  void catchUp() {
+    if (!behind_) {
+      return;
+    }
+
+    // Synchronizes with the release of every reader's snapshot
+    while (back_->readers.load() > 0) {
+      std::this_thread::yield();
+    }
+
+    for (auto& update : replay_) {
+      update(back_->tree);
+    }
+    replay_.clear();
+    behind_ = false;
+  }
+
+  std::array<std::unique_ptr<Version>, 2> versions_;
+  Version* back_ = nullptr;
+  std::atomic<Version*> published_;
+
+  std::vector<std::function<void(Tree&)>> pending_;
+  std::vector<std::function<void(Tree&)>> replay_;
+  bool behind_ = false;
+};
+
+}  // namespace algo::sgt
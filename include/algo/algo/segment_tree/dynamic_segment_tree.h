@@ -0,0 +1,223 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/segment_tree/segment_tree.h"
+#include "algo/utility/nd_container.h"
+
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace algo::sgt {
+
+/**
+ * @brief One-dimensional segment tree over [0, size) that allocates nodes lazily.
+ *
+ * Only the nodes on the paths touched by updates (and by pushes of range updates) are materialized, so
+ * the size may be as large as the whole 64-bit coordinate space. A subtree that has never been touched
+ * consists of Op::init() leaves, its value is computed once per distinct subtree length and cached.
+ *
+ * Nodes are allocated from a pool and are never freed until the tree is destroyed. Every update allocates
+ * at most O(log(size)) nodes. Queries allocate nodes only if Op defines push.
+ *
+ * Node and Op requirements are the same as for SegmentTree (see base_op), range updates are supported.
+ */
+template <typename Node, typename Op>
+class DynamicSegmentTree : public types::StatelessEngineBase<1> {
+  using T = typename Node::value_type;
+
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<1>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<1>::RangeQueryHandle;
+
+  explicit DynamicSegmentTree(const types::Index<1>& dims) : size_(dims[0]) {
+    allocate(blank(size_));
+  }
+
+  explicit DynamicSegmentTree(utility::NDView<T, 1> auto view) {
+    types::Index<1> d;
+    view.getDimensions(d);
+    size_ = d[0];
+
+    pool_.reserve(2 * size_);
+    allocate(op_.init());
+    build(kRoot, 0, size_ - 1, view);
+  }
+
+  /**
+   * @brief Number of materialized nodes.
+   */
+  [[nodiscard]] size_t nodes() const noexcept {
+    return pool_.size();
+  }
+
+  Node query(RangeQueryHandle& handle) {
+    auto& [ql, qr] = handle.getRange();
+    return query(kRoot, 0, size_ - 1, ql[0], qr[0]);
+  }
+
+  template <typename F>
+  void update(QueryHandle& handle, const F& func) {
+    update(kRoot, 0, size_ - 1, handle.getIndex()[0], func);
+  }
+
+  void update(QueryHandle& handle, const T& value) {
+    update(handle, [&value](auto& x) { x = value; });
+  }
+
+  template <typename U>
+  void updateRange(RangeQueryHandle& handle, const U& value) {
+    auto& [ql, qr] = handle.getRange();
+    updateRange(kRoot, 0, size_ - 1, ql[0], qr[0], value);
+  }
+
+ private:
+  static constexpr size_t kRoot = 0;
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  struct Item {
+    Node node;
+    size_t left = kAbsent;
+    size_t right = kAbsent;
+  };
+
+  void build(size_t v, size_t l, size_t r, utility::NDView<T, 1> auto view) {
+    if (l == r) {
+      op_.updateLeaf(pool_[v].node, view.at(l));
+      return;
+    }
+
+    size_t m = l + (r - l) / 2;
+    size_t left = allocate(op_.init());
+    size_t right = allocate(op_.init());
+    pool_[v].left = left;
+    pool_[v].right = right;
+
+    build(left, l, m, view);
+    build(right, m + 1, r, view);
+    pool_[v].node = op_.combine(pool_[left].node, pool_[right].node);
+  }
+
+  Node query(size_t v, size_t l, size_t r, size_t ql, size_t qr) {
+    if (ql > qr) {
+      return op_.neutral();
+    }
+    if (l == ql && r == qr) {
+      return value(v, l, r);
+    }
+
+    size_t m = l + (r - l) / 2;
+    size_t left = kAbsent;
+    size_t right = kAbsent;
+
+    if (v != kAbsent) {
+      push(v, l, m, r);
+      left = pool_[v].left;
+      right = pool_[v].right;
+    }
+
+    Node l_query = query(left, l, m, ql, std::min(qr, m));
+    Node r_query = query(right, m + 1, r, std::max(ql, m + 1), qr);
+    return op_.combine(l_query, r_query);
+  }
+
+  template <typename F>
+  void update(size_t v, size_t l, size_t r, size_t c, const F& func) {
+    if (l == r) {
+      func(pool_[v].node);
+      return;
+    }
+
+    size_t m = l + (r - l) / 2;
+    push(v, l, m, r);
+
+    if (c <= m) {
+      update(child<0>(v, l, m), l, m, c, func);
+    } else {
+      update(child<1>(v, m + 1, r), m + 1, r, c, func);
+    }
+
+    pool_[v].node = op_.combine(value(pool_[v].left, l, m), value(pool_[v].right, m + 1, r));
+  }
+
+  template <typename U>
+  void updateRange(size_t v, size_t l, size_t r, size_t ql, size_t qr, const U& x) {
+    if (ql > qr || op_.breakCondition(pool_[v].node, x)) {
+      return;
+    }
+    if (l == ql && r == qr && (l == r || op_.tagCondition(pool_[v].node, x))) {
+      op_.updateRange(pool_[v].node, x);
+      return;
+    }
+
+    size_t m = l + (r - l) / 2;
+    push(v, l, m, r);
+
+    if (ql <= m) {
+      updateRange(child<0>(v, l, m), l, m, ql, std::min(qr, m), x);
+    }
+    if (qr > m) {
+      updateRange(child<1>(v, m + 1, r), m + 1, r, std::max(ql, m + 1), qr, x);
+    }
+
+    pool_[v].node = op_.combine(value(pool_[v].left, l, m), value(pool_[v].right, m + 1, r));
+  }
+
+  void push(size_t v, size_t l, size_t m, size_t r) {
+    if constexpr (detail::kHasPush<Node, Op>) {
+      size_t left = child<0>(v, l, m);
+      size_t right = child<1>(v, m + 1, r);
+      op_.push(pool_[v].node, pool_[left].node, pool_[right].node);
+    }
+  }
+
+  /**
+   * @brief Returns the index of the child of v covering [l, r], materializes it if needed.
+   */
+  template <size_t Child>
+  size_t child(size_t v, size_t l, size_t r) {
+    size_t c = Child == 0 ? pool_[v].left : pool_[v].right;
+    if (c != kAbsent) {
+      return c;
+    }
+
+    c = allocate(blank(r - l + 1));
+    (Child == 0 ? pool_[v].left : pool_[v].right) = c;
+    return c;
+  }
+
+  const Node& value(size_t v, size_t l, size_t r) {
+    return v == kAbsent ? blank(r - l + 1) : pool_[v].node;
+  }
+
+  /**
+   * @brief Value of an untouched subtree with len leaves.
+   *
+   * Lengths of the subtrees at every depth differ by at most one, so at most two values per depth are cached.
+   */
+  const Node& blank(size_t len) {
+    if (auto it = blank_.find(len); it != blank_.end()) {
+      return it->second;
+    }
+
+    Node node = len == 1 ? op_.init() : op_.combine(blank(len - len / 2), blank(len / 2));
+    return blank_.emplace(len, std::move(node)).first->second;
+  }
+
+  size_t allocate(const Node& node) {
+    pool_.push_back({node});
+    return pool_.size() - 1;
+  }
+
+  [[no_unique_address]] Op op_;
+  size_t size_;
+  std::vector<Item> pool_;
+  std::unordered_map<size_t, Node> blank_;
+};
+
+template <typename T, typename Op>
+using SimpleDynamicSegmentTree = DynamicSegmentTree<simple_node<T>, simple_op<simple_node<T>, Op>>;
+
+}  // namespace algo::sgt
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+
+namespace algo::sgt {
+
+/**
+ * @brief Segment tree's storage layouts.
+ *
+ * Layout maps a node's heap index v along one dimension (the root is 1, children of v are 2v and 2v + 1)
+ * to the slot of the node in the storage.
+ *
+ * Requirements for layouts (UserLayout):
+ *  - UserLayout::init prepares the layout for a tree over the given positive number of leaves,
+ *  - UserLayout::capacity returns the number of slots the layout needs,
+ *  - UserLayout::slot maps a heap index to a slot in [0, capacity).
+ *
+ * The tree over N leaves has height H = ceil(log2(N)) + 1, hence all heap indices are less than 2^H.
+ */
+struct EytzingerLayout {
+  void init(size_t size) noexcept {
+    assert(size > 0);
+    capacity_ = size_t{2} << std::bit_width(size - 1);
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  /**
+   * @brief Plain heap order (BFS order of the nodes). Cheapest to compute, but every level of a descent
+   * lands in a different cache line once the tree is larger than a few levels.
+   */
+  [[nodiscard]] size_t slot(size_t v) const noexcept {
+    return v;
+  }
+
+ private:
+  size_t capacity_ = 0;
+};
+
+/**
+ * @brief Stores the tree as a sequence of complete subtrees of Levels levels each, every subtree in heap order.
+ *
+ * A descent touches one block per Levels levels, so the number of cache misses is reduced by a factor
+ * of Levels when a block fits into a cache line (e.g. Levels = 4 and 4-byte nodes).
+ */
+template <size_t Levels = 4>
+struct BlockedLayout {
+  static_assert(Levels > 0);
+
+  void init(size_t size) noexcept {
+    assert(size > 0);
+    height_ = std::bit_width(size - 1) + 1;
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept {
+    return size_t{1} << height_;
+  }
+
+  [[nodiscard]] size_t slot(size_t v) const noexcept {
+    const size_t depth = std::bit_width(v) - 1;
+    const size_t path = v ^ (size_t{1} << depth);
+
+    // Block level b starts at depth b * Levels. All blocks above it are complete and occupy
+    // exactly 2^(b * Levels) - 1 slots, while blocks of the last level may be lower than Levels.
+    const size_t block_depth = depth / Levels * Levels;
+    const size_t in_block_depth = depth - block_depth;
+    const size_t block_height = std::min(Levels, height_ - block_depth);
+
+    const size_t block_id = path >> in_block_depth;
+    const size_t in_block = (size_t{1} << in_block_depth) - 1 + (path & ((size_t{1} << in_block_depth) - 1));
+    return (size_t{1} << block_depth) - 1 + block_id * ((size_t{1} << block_height) - 1) + in_block;
+  }
+
+ private:
+  size_t height_ = 0;
+};
+
+/**
+ * @brief Cache-oblivious van Emde Boas layout.
+ *
+ * The tree of height H is split into the top subtree of height H / 2 and the bottom subtrees hanging from it,
+ * each of them is laid out recursively and stored contiguously. A descent touches O(log_B(N)) cache lines
+ * for any cache line size B.
+ */
+struct VanEmdeBoasLayout {
+  void init(size_t size) noexcept {
+    assert(size > 0);
+    height_ = std::bit_width(size - 1) + 1;
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept {
+    return size_t{1} << height_;
+  }
+
+  [[nodiscard]] size_t slot(size_t v) const noexcept {
+    size_t depth = std::bit_width(v) - 1;
+    size_t path = v ^ (size_t{1} << depth);
+    size_t height = height_;
+    size_t offset = 0;
+
+    while (depth > 0) {
+      const size_t top = height / 2;
+      const size_t bottom = height - top;
+
+      if (depth < top) {
+        height = top;
+        continue;
+      }
+
+      depth -= top;
+      offset += (size_t{1} << top) - 1 + (path >> depth) * ((size_t{1} << bottom) - 1);
+      path &= (size_t{1} << depth) - 1;
+      height = bottom;
+    }
+
+    return offset;
+  }
+
+ private:
+  size_t height_ = 0;
+};
+
+}  // namespace algo::sgt
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/segment_tree/segment_tree.h"
+#include "algo/utility/nd_container.h"
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace algo::sgt {
+
+/**
+ * @brief One-dimensional persistent segment tree.
+ *
+ * Every update copies the nodes on the path from the root to the updated leaf and creates a new version
+ * of the tree sharing all other nodes with the previous one. Hence an update takes O(log N) time and memory,
+ * and any version can be queried at any time.
+ *
+ * Nodes of all versions are stored in a single arena and are never freed until the tree is destroyed.
+ * Versions are numbered sequentially, the version built by the constructor is 0.
+ *
+ * Node and Op requirements are the same as for SegmentTree (see base_op), except that range updates
+ * are not supported: Op::push and Op::updateRange are never called.
+ */
+template <typename Node, typename Op>
+class PersistentSegmentTree : public types::StatelessEngineBase<1> {
+  using T = typename Node::value_type;
+
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<1>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<1>::RangeQueryHandle;
+  using Version = size_t;
+
+  explicit PersistentSegmentTree(const types::Index<1>& dims) : size_(dims[0]) {
+    arena_.reserve(2 * size_);
+    roots_.push_back(build(0, size_ - 1, [this](size_t) { return op_.init(); }));
+  }
+
+  explicit PersistentSegmentTree(utility::NDView<T, 1> auto view) {
+    types::Index<1> d;
+    view.getDimensions(d);
+    size_ = d[0];
+    arena_.reserve(2 * size_);
+
+    roots_.push_back(build(0, size_ - 1, [this, &view](size_t i) {
+      Node node = op_.init();
+      op_.updateLeaf(node, view.at(i));
+      return node;
+    }));
+  }
+
+  [[nodiscard]] Version latest() const noexcept {
+    return roots_.size() - 1;
+  }
+
+  [[nodiscard]] size_t versions() const noexcept {
+    return roots_.size();
+  }
+
+  Node query(Version version, RangeQueryHandle& handle) {
+    assert(version < roots_.size());
+    auto& [ql, qr] = handle.getRange();
+    return query(roots_[version], 0, size_ - 1, ql[0], qr[0]);
+  }
+
+  Node query(RangeQueryHandle& handle) {
+    return query(latest(), handle);
+  }
+
+  /**
+   * @brief Applies func to the leaf of the given version and returns the new version.
+   */
+  template <typename F>
+  Version update(Version version, QueryHandle& handle, const F& func) {
+    assert(version < roots_.size());
+    roots_.push_back(update(roots_[version], 0, size_ - 1, handle.getIndex()[0], func));
+    return latest();
+  }
+
+  Version update(Version version, QueryHandle& handle, const T& value) {
+    return update(version, handle, [&value](auto& x) { x = value; });
+  }
+
+  template <typename F>
+  Version update(QueryHandle& handle, const F& func) {
+    return update(latest(), handle, func);
+  }
+
+  Version update(QueryHandle& handle, const T& value) {
+    return update(latest(), handle, value);
+  }
+
+ private:
+  struct Item {
+    Node node;
+    size_t left = 0;
+    size_t right = 0;
+  };
+
+  template <typename MakeLeaf>
+  size_t build(size_t l, size_t r, const MakeLeaf& make_leaf) {
+    if (l == r) {
+      return allocate({make_leaf(l)});
+    }
+
+    size_t m = l + (r - l) / 2;
+    size_t left = build(l, m, make_leaf);
+    size_t right = build(m + 1, r, make_leaf);
+    return allocate({op_.combine(arena_[left].node, arena_[right].node), left, right});
+  }
+
+  Node query(size_t v, size_t l, size_t r, size_t ql, size_t qr) {
+    if (ql > qr) {
+      return op_.neutral();
+    }
+    if (l == ql && r == qr) {
+      return arena_[v].node;
+    }
+
+    size_t m = l + (r - l) / 2;
+    Node l_query = query(arena_[v].left, l, m, ql, std::min(qr, m));
+    Node r_query = query(arena_[v].right, m + 1, r, std::max(ql, m + 1), qr);
+    return op_.combine(l_query, r_query);
+  }
+
+  template <typename F>
+  size_t update(size_t v, size_t l, size_t r, size_t c, const F& func) {
+    if (l == r) {
+      Item leaf = arena_[v];
+      func(leaf.node);
+      return allocate(std::move(leaf));
+    }
+
+    size_t m = l + (r - l) / 2;
+    size_t left = arena_[v].left;
+    size_t right = arena_[v].right;
+
+    if (c <= m) {
+      left = update(left, l, m, c, func);
+    } else {
+      right = update(right, m + 1, r, c, func);
+    }
+
+    return allocate({op_.combine(arena_[left].node, arena_[right].node), left, right});
+  }
+
+  size_t allocate(Item&& item) {
+    arena_.push_back(std::move(item));
+    return arena_.size() - 1;
+  }
+
+  [[no_unique_address]] Op op_;
+  size_t size_;
+  std::vector<Item> arena_;
+  std::vector<size_t> roots_;
+};
+
+template <typename T, typename Op>
+using SimplePersistentSegmentTree = PersistentSegmentTree<simple_node<T>, simple_op<simple_node<T>, Op>>;
+
+}  // namespace algo::sgt
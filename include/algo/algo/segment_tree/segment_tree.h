@@ -1,22 +1,35 @@
 #pragma once
 
 #include "algo/common/types.h"
+#include "algo/segment_tree/layout.h"
 #include "algo/utility/nd_container.h"
 
 #include <algorithm>
+#include <cassert>
 #include <concepts>
 #include <cstddef>
 #include <iostream>
 #include <numeric>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace algo::sgt {
 
-template <typename Node, typename Op, size_t NDims>
+template <typename Node, typename Op, size_t NDims, typename Layout>
 class SegmentTree;
 
+template <typename Node, typename Op>
+struct base_op;
+
 namespace detail {
 
+// base_op::push is a no-op, there is nothing to propagate to the children unless Op overrides it
+template <typename Node, typename Op>
+inline constexpr bool kHasPush = !std::is_same_v<decltype(&Op::push), decltype(&base_op<Node, Op>::push)>;
+
 template <size_t NDims>
 struct Position {
   explicit Position(const types::Index<NDims>& dims) noexcept {
@@ -44,7 +57,7 @@ struct QueryHandle {
   types::Index<NDims> index_;
   Position<NDims> position_;
 
-  template <typename T, typename Op, size_t Dims>
+  template <typename T, typename Op, size_t Dims, typename Layout>
   friend class sgt::SegmentTree;
 };
 
@@ -60,13 +73,24 @@ struct RangeQueryHandle {
   types::Range<NDims> range_;
   Position<NDims> position_;
 
-  template <typename T, typename Op, size_t Dims>
+  template <typename T, typename Op, size_t Dims, typename Layout>
   friend class sgt::SegmentTree;
 };
 
+struct BatchItem {
+  size_t l;
+  size_t r;
+  size_t id;
+};
+
 }  // namespace detail
 
-template <typename Node, typename Op, size_t NDims = 1>
+/**
+ * @brief Multi-dimensional segment tree.
+ *
+ * Layout defines the order in which the nodes of every dimension are stored (see layout.h).
+ */
+template <typename Node, typename Op, size_t NDims = 1, typename Layout = EytzingerLayout>
 class SegmentTree {
   using T = typename Node::value_type;
 
@@ -74,8 +98,9 @@ class SegmentTree {
   using QueryHandle = detail::QueryHandle<NDims>;
   using RangeQueryHandle = detail::RangeQueryHandle<NDims>;
 
-  explicit SegmentTree(types::Index<NDims>& sizes) {
-    initDims(sizes);
+  explicit SegmentTree(const types::Index<NDims>& dims) {
+    dims_ = dims;
+    initDims();
   }
 
   explicit SegmentTree(utility::NDView<T, NDims> auto view) {
@@ -86,6 +111,21 @@ class SegmentTree {
     build<0>(view, position);
   }
 
+  /**
+   * @brief Builds the tree using up to num_threads threads.
+   *
+   * Subtrees of the first dimension are independent and occupy disjoint parts of the storage, so the top
+   * ceil(log2(num_threads)) levels are split between the threads and combined after their children are built.
+   * Op::combine and Op::updateLeaf must be safe to call concurrently on different nodes.
+   */
+  SegmentTree(utility::NDView<T, NDims> auto view, size_t num_threads) {
+    view.getDimensions(dims_);
+    initDims();
+
+    detail::Position<NDims> position{dims_};
+    buildParallel(view, position, std::max<size_t>(num_threads, 1));
+  }
+
   [[nodiscard]] QueryHandle getQueryHandle() const noexcept {
     return QueryHandle(dims_);
   }
@@ -95,7 +135,92 @@ class SegmentTree {
   }
 
   Node query(RangeQueryHandle& handle) {
-    return query<0>(handle);
+    return query<0>(*this, op_, handle);
+  }
+
+  /**
+   * @brief Same as query, but never modifies the tree, hence may be called concurrently.
+   *
+   * Pending range updates are not pushed down, so if Op defines push the tree must be flushed
+   * after the last range update.
+   */
+  Node query(RangeQueryHandle& handle) const {
+    // Members of Op are not const, a copy of it is used instead
+    Op op = op_;
+    return query<0>(*this, op, handle);
+  }
+
+  /**
+   * @brief Pushes all pending range updates down to the leaves. Takes O(size of the storage).
+   */
+  void flush() {
+    if constexpr (detail::kHasPush<Node, Op>) {
+      detail::Position<NDims> position{dims_};
+      flush<0>(position);
+    }
+  }
+
+  /**
+   * @brief Answers a batch of range queries in a single traversal of the tree.
+   *
+   * Queries are grouped by the nodes they visit, and a node shared by more than kBatchDescentThreshold
+   * queries of the batch is visited once for all of them. Smaller groups descend further one query at a time,
+   * so nodes near the leaves are still visited once per query. Result of ranges[i] is written to out[i].
+   *
+   * Every query is still classified at every node it visits, so the gain comes from better memory locality
+   * and is noticeable for large trees and heavy nodes only. The groups are kept in a scratch buffer of
+   * O(Q * (sum of the tree depths along all dimensions)) items for Q queries.
+   */
+  void queryBatch(std::span<const types::Range<NDims>> ranges, std::span<Node> out) {
+    assert(ranges.size() == out.size());
+    std::vector<detail::BatchItem> items;
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      out[i] = op_.neutral();
+      const auto& [qls, qrs] = ranges[i];
+      if (std::equal(qls.begin(), qls.end(), qrs.begin(), std::less_equal<>())) {
+        items.push_back({qls[0], qrs[0], i});
+      }
+    }
+
+    detail::Position<NDims> position{dims_};
+    if (const size_t count = items.size(); count > 0) {
+      queryBatch<0>(ranges, out, items, count, 0, count, position);
+    }
+  }
+
+  /**
+   * @brief Returns the largest r in [l, N] such that pred(combine(a[l], ..., a[r - 1])) holds.
+   *
+   * pred must hold for Op::neutral() and be monotone: if it holds for a segment, it holds for all
+   * its prefixes. Takes O(log N) calls to Op::combine and pred.
+   */
+  template <typename Pred>
+    requires(NDims == 1)
+  size_t maxRight(size_t l, const Pred& pred) {
+    if (l == dims_[0]) {
+      return l;
+    }
+    types::Index<NDims> vs{{1}};
+    Node acc = op_.neutral();
+    return maxRight(l, pred, vs, 0, dims_[0] - 1, acc);
+  }
+
+  /**
+   * @brief Returns the smallest l in [0, r] such that pred(combine(a[l], ..., a[r - 1])) holds.
+   *
+   * pred must hold for Op::neutral() and be monotone: if it holds for a segment, it holds for all
+   * its suffixes. Takes O(log N) calls to Op::combine and pred.
+   */
+  template <typename Pred>
+    requires(NDims == 1)
+  size_t minLeft(size_t r, const Pred& pred) {
+    if (r == 0) {
+      return r;
+    }
+    types::Index<NDims> vs{{1}};
+    Node acc = op_.neutral();
+    return minLeft(r - 1, pred, vs, 0, dims_[0] - 1, acc);
   }
 
   template <typename F>
@@ -107,7 +232,13 @@ class SegmentTree {
     update<0>(handle, [&value](auto& x) { x = value; });
   }
 
-  void updateRange(RangeQueryHandle& handle, const T& value) {
+  /**
+   * @brief Applies the range update to all elements of the range.
+   *
+   * The update is passed to Op::updateRange as is, so it may be of any type Op accepts (e.g. see beats.h).
+   */
+  template <typename U>
+  void updateRange(RangeQueryHandle& handle, const U& value) {
     updateRange<0>(handle, value);
   }
 
@@ -137,26 +268,59 @@ class SegmentTree {
       ls[I] = l;
       rs[I] = r;
     }
+    buildNode<I>(view, position);
+  }
+
+  void buildParallel(utility::NDView<T, NDims> auto view, detail::Position<NDims>& position, size_t num_threads) {
+    auto& [vs, ls, rs] = position;
+
+    size_t l = ls[0];
+    size_t r = rs[0];
+
+    if (num_threads == 1 || l == r) {
+      build<0>(view, position);
+      return;
+    }
+
+    size_t m = l + (r - l) / 2;
+    size_t v = vs[0];
+
+    detail::Position<NDims> left = position;
+    left.vs[0] = 2 * v;
+    left.rs[0] = m;
+    std::thread worker([&, view] { buildParallel(view, left, num_threads / 2); });
+
+    vs[0] = 2 * v + 1;
+    ls[0] = m + 1;
+    buildParallel(view, position, num_threads - num_threads / 2);
+    worker.join();
+
+    vs[0] = v;
+    ls[0] = l;
+    buildNode<0>(view, position);
+  }
+
+  template <size_t I>
+  void buildNode(utility::NDView<T, NDims> auto view, detail::Position<NDims>& position) {
     if constexpr (I < NDims - 1) {
       build<I + 1>(view, position);
       return;
     }
 
+    auto& [vs, ls, rs] = position;
+    size_t l = ls[I];
+    size_t r = rs[I];
     size_t t_idx = indicesToLinearIndex(vs);
 
     if (l != r) {
-      size_t t_idx_l = t_idx + vs[I] * strides_[I];
-      size_t t_idx_r = t_idx_l + strides_[I];
-      storage_[t_idx] = op_.combine(storage_[t_idx_l], storage_[t_idx_r]);
+      storage_[t_idx] = op_.combine(storage_[childIndex(t_idx, vs, I, 0)], storage_[childIndex(t_idx, vs, I, 1)]);
     } else {
       for (size_t i = 0; i < NDims - 1; ++i) {
         if (ls[i] == rs[i]) {
           continue;
         }
 
-        size_t t_idx_l = t_idx + vs[i] * strides_[i];
-        size_t t_idx_r = t_idx_l + strides_[i];
-        storage_[t_idx] = op_.combine(storage_[t_idx_l], storage_[t_idx_r]);
+        storage_[t_idx] = op_.combine(storage_[childIndex(t_idx, vs, i, 0)], storage_[childIndex(t_idx, vs, i, 1)]);
         return;
       }
       op_.updateLeaf(storage_[t_idx], view.at(ls));
@@ -164,22 +328,54 @@ class SegmentTree {
   }
 
   template <size_t I>
-  Node query(RangeQueryHandle& handle) {
+  void flush(detail::Position<NDims>& position) {
+    auto& [vs, ls, rs] = position;
+
+    size_t l = ls[I];
+    size_t r = rs[I];
+
+    if constexpr (I < NDims - 1) {
+      flush<I + 1>(position);
+    } else if (l != r) {
+      push(indicesToLinearIndex(vs), vs);
+    }
+
+    if (l != r) {
+      size_t m = l + (r - l) / 2;
+      size_t v = vs[I];
+
+      vs[I] = 2 * v;
+      rs[I] = m;
+      flush<I>(position);
+
+      vs[I] = 2 * v + 1;
+      ls[I] = m + 1;
+      rs[I] = r;
+      flush<I>(position);
+
+      vs[I] = v;
+      ls[I] = l;
+    }
+  }
+
+  // Pushes pending range updates down on the way, unless the tree is const and must not be modified
+  template <size_t I, typename Self>
+  static Node query(Self& self, Op& op, RangeQueryHandle& handle) {
     auto& [range, position] = handle;
     auto& [qls, qrs] = range;
     auto& [vs, ls, rs] = position;
 
     if (qls[I] > qrs[I]) {
-      return op_.neutral();
+      return op.neutral();
     }
 
-    size_t t_idx = indicesToLinearIndex(vs);
+    size_t t_idx = self.indicesToLinearIndex(vs);
 
     if (ls[I] == qls[I] && rs[I] == qrs[I]) {
       if constexpr (I == NDims - 1) {
-        return storage_[t_idx];
+        return self.storage_[t_idx];
       } else {
-        return query<I + 1>(handle);
+        return query<I + 1>(self, op, handle);
       }
     }
 
@@ -190,21 +386,21 @@ class SegmentTree {
     size_t qr = qrs[I];
     size_t m = l + (r - l) / 2;
 
-    if constexpr (I == NDims - 1) {
-      op_.push(storage_[t_idx], storage_[t_idx + v], storage_[t_idx + v + 1]);
+    if constexpr (I == NDims - 1 && !std::is_const_v<Self>) {
+      self.push(t_idx, vs);
     }
 
     vs[I] = 2 * v;
     rs[I] = m;
     qrs[I] = std::min(qr, m);
-    Node l_query = query<I>(handle);
+    Node l_query = query<I>(self, op, handle);
 
     vs[I] = 2 * v + 1;
     ls[I] = m + 1;
     rs[I] = r;
     qls[I] = std::max(ql, m + 1);
     qrs[I] = qr;
-    Node r_query = query<I>(handle);
+    Node r_query = query<I>(self, op, handle);
 
     vs[I] = v;
     ls[I] = l;
@@ -212,7 +408,173 @@ class SegmentTree {
     qls[I] = ql;
     qrs[I] = qr;
 
-    return op_.combine(l_query, r_query);
+    return op.combine(l_query, r_query);
+  }
+
+  /*
+   * items[first, last) are the queries intersecting the current node, with their bounds along the I-th dimension.
+   * Groups for the node itself and for its children are written starting at items[top], every group gets a region
+   * of (last - first) items. Small groups are answered by the regular recursive descent.
+   */
+  template <size_t I>
+  void queryBatch(
+      std::span<const types::Range<NDims>> ranges, std::span<Node> out, std::vector<detail::BatchItem>& items,
+      size_t top, size_t first, size_t last, detail::Position<NDims>& position) {
+    auto& [vs, ls, rs] = position;
+
+    size_t v = vs[I];
+    size_t l = ls[I];
+    size_t r = rs[I];
+    size_t m = l + (r - l) / 2;
+
+    if (last - first <= kBatchDescentThreshold) {
+      RangeQueryHandle handle(dims_);
+      handle.position_ = position;
+      for (size_t i = first; i < last; ++i) {
+        const auto item = items[i];
+        handle.range_ = ranges[item.id];
+        handle.range_.left[I] = std::max(l, item.l);
+        handle.range_.right[I] = std::min(r, item.r);
+        out[item.id] = op_.combine(out[item.id], query<I>(*this, op_, handle));
+      }
+      return;
+    }
+
+    const size_t count = last - first;
+    const size_t to_left = top;
+    const size_t to_right = to_left + count;
+    const size_t covered = to_right + count;
+    const size_t next_top = covered + (I < NDims - 1 ? count : 0);
+    if (items.size() < next_top) {
+      items.resize(2 * next_top);
+    }
+
+    size_t t_idx = indicesToLinearIndex(vs);
+    size_t left_end = to_left;
+    size_t right_end = to_right;
+    size_t covered_end = covered;
+
+    // Children groups are filled without branching on the bounds, they are random and would be mispredicted
+    auto* data = items.data();
+    const Node& node = storage_[t_idx];
+    for (size_t i = first; i < last; ++i) {
+      const auto item = data[i];
+      if (item.l <= l && r <= item.r) {
+        if constexpr (I == NDims - 1) {
+          out[item.id] = op_.combine(out[item.id], node);
+        } else {
+          data[covered_end++] = {ranges[item.id].left[I + 1], ranges[item.id].right[I + 1], item.id};
+        }
+        continue;
+      }
+      data[left_end] = item;
+      left_end += item.l <= m;
+      data[right_end] = item;
+      right_end += m < item.r;
+    }
+
+    if constexpr (I < NDims - 1) {
+      if (covered < covered_end) {
+        queryBatch<I + 1>(ranges, out, items, next_top, covered, covered_end, position);
+      }
+    }
+
+    if (to_left < left_end || to_right < right_end) {
+      if constexpr (I == NDims - 1) {
+        push(t_idx, vs);
+      }
+
+      if (to_left < left_end) {
+        vs[I] = 2 * v;
+        rs[I] = m;
+        queryBatch<I>(ranges, out, items, next_top, to_left, left_end, position);
+      }
+
+      if (to_right < right_end) {
+        vs[I] = 2 * v + 1;
+        ls[I] = m + 1;
+        rs[I] = r;
+        queryBatch<I>(ranges, out, items, next_top, to_right, right_end, position);
+      }
+
+      vs[I] = v;
+      ls[I] = l;
+      rs[I] = r;
+    }
+  }
+
+  /**
+   * @brief Returns the first index in [max(ql, l), r] at which pred fails for the prefix started at ql,
+   * or r + 1 if there is no such index. acc holds the combination of [ql, l - 1] and is extended.
+   */
+  template <typename Pred>
+  size_t maxRight(size_t ql, const Pred& pred, types::Index<NDims>& vs, size_t l, size_t r, Node& acc) {
+    size_t t_idx = indicesToLinearIndex(vs);
+
+    if (ql <= l) {
+      Node next = op_.combine(acc, storage_[t_idx]);
+      if (pred(next)) {
+        acc = std::move(next);
+        return r + 1;
+      }
+      if (l == r) {
+        return l;
+      }
+    }
+
+    push(t_idx, vs);
+    size_t m = l + (r - l) / 2;
+    size_t v = vs[0];
+    size_t result = m + 1;
+
+    if (ql <= m) {
+      vs[0] = 2 * v;
+      result = maxRight(ql, pred, vs, l, m, acc);
+    }
+    if (result == m + 1) {
+      vs[0] = 2 * v + 1;
+      result = maxRight(ql, pred, vs, m + 1, r, acc);
+    }
+
+    vs[0] = v;
+    return result;
+  }
+
+  /**
+   * @brief Returns the smallest l' in [l, min(qr, r) + 1] such that pred holds for [l', qr].
+   * acc holds the combination of [r + 1, qr] and is extended.
+   */
+  template <typename Pred>
+  size_t minLeft(size_t qr, const Pred& pred, types::Index<NDims>& vs, size_t l, size_t r, Node& acc) {
+    size_t t_idx = indicesToLinearIndex(vs);
+
+    if (r <= qr) {
+      Node next = op_.combine(storage_[t_idx], acc);
+      if (pred(next)) {
+        acc = std::move(next);
+        return l;
+      }
+      if (l == r) {
+        return l + 1;
+      }
+    }
+
+    push(t_idx, vs);
+    size_t m = l + (r - l) / 2;
+    size_t v = vs[0];
+    size_t result = m + 1;
+
+    if (qr > m) {
+      vs[0] = 2 * v + 1;
+      result = minLeft(qr, pred, vs, m + 1, r, acc);
+    }
+    if (result == m + 1) {
+      vs[0] = 2 * v;
+      result = minLeft(qr, pred, vs, l, m, acc);
+    }
+
+    vs[0] = v;
+    return result;
   }
 
   template <size_t I, typename F>
@@ -226,11 +588,11 @@ class SegmentTree {
     size_t v = vs[I];
     size_t t_idx = indicesToLinearIndex(vs);
 
-    if constexpr (I == NDims - 1) {
-      op_.push(storage_[t_idx], storage_[t_idx + v], storage_[t_idx + v + 1]);
-    }
-
     if (l != r) {
+      if constexpr (I == NDims - 1) {
+        push(t_idx, vs);
+      }
+
       size_t m = l + (r - l) / 2;
 
       if (c <= m) {
@@ -255,24 +617,20 @@ class SegmentTree {
     }
 
     if (l != r) {
-      size_t t_idx_l = t_idx + vs[I] * strides_[I];
-      size_t t_idx_r = t_idx_l + strides_[I];
-      storage_[t_idx] = op_.combine(storage_[t_idx_l], storage_[t_idx_r]);
+      storage_[t_idx] = op_.combine(storage_[childIndex(t_idx, vs, I, 0)], storage_[childIndex(t_idx, vs, I, 1)]);
     } else {
       for (size_t i = 0; i < NDims - 1; ++i) {
         if (ls[i] == rs[i])
           continue;
-        size_t t_idx_l = t_idx + vs[i] * strides_[i];
-        size_t t_idx_r = t_idx_l + strides_[i];
-        storage_[t_idx] = op_.combine(storage_[t_idx_l], storage_[t_idx_r]);
+        storage_[t_idx] = op_.combine(storage_[childIndex(t_idx, vs, i, 0)], storage_[childIndex(t_idx, vs, i, 1)]);
         return;
       }
       func(storage_[t_idx]);
     }
   }
 
-  template <size_t I>
-  void updateRange(RangeQueryHandle& handle, const T& value) {
+  template <size_t I, typename U>
+  void updateRange(RangeQueryHandle& handle, const U& value) {
     auto& [range, position] = handle;
     auto& [qls, qrs] = range;
     auto& [vs, ls, rs] = position;
@@ -283,13 +641,22 @@ class SegmentTree {
 
     size_t t_idx = indicesToLinearIndex(vs);
 
+    if constexpr (I == NDims - 1) {
+      if (op_.breakCondition(storage_[t_idx], value)) {
+        return;
+      }
+    }
+
     if (ls[I] == qls[I] && rs[I] == qrs[I]) {
       if constexpr (I == NDims - 1) {
-        op_.updateRange(storage_[t_idx], value);
+        if (ls[I] == rs[I] || op_.tagCondition(storage_[t_idx], value)) {
+          op_.updateRange(storage_[t_idx], value);
+          return;
+        }
       } else {
         updateRange<I + 1>(handle, value);
+        return;
       }
-      return;
     }
 
     size_t v = vs[I];
@@ -300,7 +667,7 @@ class SegmentTree {
     size_t m = l + (r - l) / 2;
 
     if constexpr (I == NDims - 1) {
-      op_.push(storage_[t_idx], storage_[t_idx + v], storage_[t_idx + v + 1]);
+      push(t_idx, vs);
     }
 
     vs[I] = 2 * v;
@@ -322,26 +689,43 @@ class SegmentTree {
     qrs[I] = qr;
 
     if constexpr (I == NDims - 1) {
-      storage_[t_idx] = op_.combine(storage_[t_idx + v], storage_[t_idx + v + 1]);
+      storage_[t_idx] = op_.combine(storage_[childIndex(t_idx, vs, I, 0)], storage_[childIndex(t_idx, vs, I, 1)]);
     }
   }
 
+  void push(size_t t_idx, const types::Index<NDims>& vs) {
+    op_.push(storage_[t_idx], storage_[childIndex(t_idx, vs, NDims - 1, 0)], storage_[childIndex(t_idx, vs, NDims - 1, 1)]);
+  }
+
+  size_t childIndex(size_t t_idx, const types::Index<NDims>& vs, size_t dim, size_t child) const noexcept {
+    const auto& layout = layouts_[dim];
+    return t_idx + (layout.slot(2 * vs[dim] + child) - layout.slot(vs[dim])) * strides_[dim];
+  }
+
   void initDims() {
     size_t stride = 1;
     for (size_t dim = NDims; dim-- > 0;) {
+      layouts_[dim].init(dims_[dim]);
       strides_[dim] = stride;
-      stride *= 4 * dims_[dim];
+      stride *= layouts_[dim].capacity();
     }
     storage_.assign(stride, op_.init());
   }
 
-  size_t indicesToLinearIndex(types::Index<NDims>& idxs) {
-    return std::inner_product(strides_.begin(), strides_.end(), idxs.begin(), 0);
+  size_t indicesToLinearIndex(const types::Index<NDims>& idxs) const noexcept {
+    size_t index = 0;
+    for (size_t dim = 0; dim < NDims; ++dim) {
+      index += layouts_[dim].slot(idxs[dim]) * strides_[dim];
+    }
+    return index;
   }
 
+  static constexpr size_t kBatchDescentThreshold = 4;
+
   [[no_unique_address]] Op op_;
   types::Index<NDims> dims_;
   types::Index<NDims> strides_;
+  std::array<Layout, NDims> layouts_;
   std::vector<Node> storage_;
 };
 
@@ -394,6 +778,11 @@ struct simple_node {
  *  - UserOp::push propagates segment-wise changes to its children,
  *  - UserOp::updateRange updates the node's accumulators for range updates.
  *
+ * Optional operations for segment tree beats (see beats.h):
+ *  - UserOp::breakCondition returns true if the range update does not change the node's subtree,
+ *  - UserOp::tagCondition returns true if the range update can be applied to the node with
+ * UserOp::updateRange, otherwise the update descends further. Leaves are always updated.
+ *
  * This particular implementation is meant for Node = simple_node<typename
  * Node::value_type> and simply applies Operation::operator() whenever needed.
  *
@@ -414,6 +803,16 @@ struct base_op {
   void push(Node&, Node&, Node&) {}
   void updateRange(Node&, const typename Node::value_type&) {}
 
+  // By default range updates are applied to the fully covered nodes
+  template <typename U>
+  bool breakCondition(const Node&, const U&) {
+    return false;
+  }
+  template <typename U>
+  bool tagCondition(const Node&, const U&) {
+    return true;
+  }
+
  private:
   Op& self() noexcept {
     return *static_cast<Op*>(this);
@@ -443,7 +842,7 @@ struct simple_op : public base_op<Node, simple_op<Node, Operation>> {
   [[no_unique_address]] Operation op;
 };
 
-template <typename T, typename Op, size_t NDims = 1>
-using SimpleSegmentTree = SegmentTree<simple_node<T>, simple_op<simple_node<T>, Op>, NDims>;
+template <typename T, typename Op, size_t NDims = 1, typename Layout = EytzingerLayout>
+using SimpleSegmentTree = SegmentTree<simple_node<T>, simple_op<simple_node<T>, Op>, NDims, Layout>;
 
 }  // namespace algo::sgt
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/utility/nd_container.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace algo::sgt {
+
+/**
+ * @brief Reductions that SimdSegmentTree can evaluate with vector instructions.
+ */
+enum class SimdReduction { kNone, kMin, kMax, kSum };
+
+/**
+ * @brief Tells SimdSegmentTree which vectorized kernel is equivalent to Op.
+ *
+ * Specialize it for the operation to enable the kernels, the default kNone evaluates Op with a scalar loop.
+ */
+template <typename Op>
+struct simd_reduction : std::integral_constant<SimdReduction, SimdReduction::kNone> {};
+
+namespace detail {
+
+#if defined(__AVX2__)
+
+struct SimdIsa {
+  using Vec = __m256i;
+  static constexpr size_t kWidth = 8;
+
+  static Vec load(const int32_t* p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const Vec*>(p));
+  }
+  static Vec set1(int32_t x) noexcept {
+    return _mm256_set1_epi32(x);
+  }
+  static Vec lanes() noexcept {
+    return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  }
+  static Vec add(Vec a, Vec b) noexcept {
+    return _mm256_add_epi32(a, b);
+  }
+  // Lanes where from <= lane < to
+  static Vec inside(Vec lane, Vec from, Vec to) noexcept {
+    return _mm256_andnot_si256(_mm256_cmpgt_epi32(from, lane), _mm256_cmpgt_epi32(to, lane));
+  }
+  static Vec select(Vec mask, Vec a, Vec b) noexcept {
+    return _mm256_blendv_epi8(b, a, mask);
+  }
+  template <typename Combine>
+  static int32_t horizontal(Vec v, Combine combine) noexcept {
+    __m128i x = combine(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    x = combine(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = combine(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(x);
+  }
+};
+
+#elif defined(__SSE4_1__)
+
+struct SimdIsa {
+  using Vec = __m128i;
+  static constexpr size_t kWidth = 4;
+
+  static Vec load(const int32_t* p) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<const Vec*>(p));
+  }
+  static Vec set1(int32_t x) noexcept {
+    return _mm_set1_epi32(x);
+  }
+  static Vec lanes() noexcept {
+    return _mm_setr_epi32(0, 1, 2, 3);
+  }
+  static Vec add(Vec a, Vec b) noexcept {
+    return _mm_add_epi32(a, b);
+  }
+  // Lanes where from <= lane < to
+  static Vec inside(Vec lane, Vec from, Vec to) noexcept {
+    return _mm_andnot_si128(_mm_cmpgt_epi32(from, lane), _mm_cmpgt_epi32(to, lane));
+  }
+  static Vec select(Vec mask, Vec a, Vec b) noexcept {
+    return _mm_blendv_epi8(b, a, mask);
+  }
+  template <typename Combine>
+  static int32_t horizontal(Vec x, Combine combine) noexcept {
+    x = combine(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = combine(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(x);
+  }
+};
+
+#endif
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+
+template <SimdReduction R, typename T>
+constexpr bool kHasSimdKernel = R != SimdReduction::kNone && std::is_same_v<T, int32_t>;
+
+template <SimdReduction R>
+struct SimdCombine {
+  __m128i operator()(__m128i a, __m128i b) const noexcept {
+    if constexpr (R == SimdReduction::kMin) {
+      return _mm_min_epi32(a, b);
+    } else if constexpr (R == SimdReduction::kMax) {
+      return _mm_max_epi32(a, b);
+    } else {
+      return _mm_add_epi32(a, b);
+    }
+  }
+
+#if defined(__AVX2__)
+  __m256i operator()(__m256i a, __m256i b) const noexcept {
+    if constexpr (R == SimdReduction::kMin) {
+      return _mm256_min_epi32(a, b);
+    } else if constexpr (R == SimdReduction::kMax) {
+      return _mm256_max_epi32(a, b);
+    } else {
+      return _mm256_add_epi32(a, b);
+    }
+  }
+#endif
+};
+
+/**
+ * @brief Reduces block[from, to) of a block of BlockSize elements, lanes outside of the range are
+ * replaced with neutral.
+ */
+template <SimdReduction R, size_t BlockSize>
+int32_t simdReduce(const int32_t* block, size_t from, size_t to, int32_t neutral) noexcept {
+  using Isa = SimdIsa;
+  using Vec = typename Isa::Vec;
+  static_assert(BlockSize % Isa::kWidth == 0);
+
+  const SimdCombine<R> combine;
+
+  const Vec fill = Isa::set1(neutral);
+  const Vec lo = Isa::set1(int32_t(from));
+  const Vec hi = Isa::set1(int32_t(to));
+  Vec lane = Isa::add(Isa::lanes(), Isa::set1(int32_t(from / Isa::kWidth * Isa::kWidth)));
+  Vec acc = fill;
+
+  for (size_t i = from / Isa::kWidth * Isa::kWidth; i < to; i += Isa::kWidth) {
+    Vec x = Isa::select(Isa::inside(lane, lo, hi), Isa::load(block + i), fill);
+    acc = combine(acc, x);
+    lane = Isa::add(lane, Isa::set1(int32_t(Isa::kWidth)));
+  }
+
+  return Isa::horizontal(acc, combine);
+}
+
+#else
+
+template <SimdReduction R, typename T>
+constexpr bool kHasSimdKernel = false;
+
+template <SimdReduction R, size_t BlockSize>
+int32_t simdReduce(const int32_t*, size_t, size_t, int32_t) noexcept;
+
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief One-dimensional segment tree with leaves grouped into blocks of Block consecutive elements.
+ *
+ * Elements are stored in a flat array, the bottom-up tree (see BottomUpSegmentTree) is built over
+ * the aggregates of the blocks, which makes it log2(Block) levels shorter. The partial blocks at the
+ * ends of a query and the aggregate of an updated block are reduced with AVX2 / SSE4.1 kernels when
+ * simd_reduction<Op> names the reduction and T is int32_t, otherwise with a scalar loop.
+ * The kernels are enabled by compiling for the matching instruction set (e.g. -march=native).
+ *
+ * Op requirements are the same as for simple_op: Op::operator() combines two values and
+ * Op::neutral returns the neutral element.
+ */
+template <typename T, typename Op, size_t Block = 16>
+class SimdSegmentTree : public types::StatelessEngineBase<1> {
+  static_assert(Block > 0 && Block % 8 == 0, "Block must be a positive multiple of the vector width");
+
+  static constexpr SimdReduction kReduction = simd_reduction<Op>::value;
+
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<1>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<1>::RangeQueryHandle;
+
+  explicit SimdSegmentTree(const types::Index<1>& dims) {
+    initDims(dims);
+    build();
+  }
+
+  explicit SimdSegmentTree(utility::NDView<T, 1> auto view) {
+    types::Index<1> d;
+    view.getDimensions(d);
+    initDims(d);
+
+    for (size_t i = 0; i < size_; ++i) {
+      values_[i] = view.at(i);
+    }
+    build();
+  }
+
+  T query(RangeQueryHandle& handle) {
+    auto& [ql, qr] = handle.getRange();
+    size_t lb = ql[0] / Block;
+    size_t rb = qr[0] / Block;
+
+    if (lb == rb) {
+      return reduce(lb, ql[0] % Block, qr[0] % Block + 1);
+    }
+
+    T left = reduce(lb, ql[0] % Block, Block);
+    T right = reduce(rb, 0, qr[0] % Block + 1);
+
+    for (size_t l = lb + 1 + blocks_, r = rb + blocks_; l < r; l >>= 1, r >>= 1) {
+      if (l & 1) {
+        left = op_(left, tree_[l++]);
+      }
+      if (r & 1) {
+        right = op_(tree_[--r], right);
+      }
+    }
+
+    return op_(left, right);
+  }
+
+  template <typename F>
+  void update(QueryHandle& handle, const F& func) {
+    size_t i = handle.getIndex()[0];
+    func(values_[i]);
+
+    size_t v = i / Block + blocks_;
+    tree_[v] = reduce(i / Block, 0, Block);
+    for (v >>= 1; v > 0; v >>= 1) {
+      tree_[v] = op_(tree_[2 * v], tree_[2 * v + 1]);
+    }
+  }
+
+  void update(QueryHandle& handle, const T& value) {
+    update(handle, [&value](auto& x) { x = value; });
+  }
+
+ private:
+  void initDims(const types::Index<1>& d) {
+    size_ = d[0];
+    blocks_ = (size_ + Block - 1) / Block;
+
+    // The tail of the last block is padded with neutral elements, so that blocks are always full
+    values_.assign(blocks_ * Block, op_.neutral());
+    std::fill(values_.begin(), values_.begin() + size_, op_.init());
+    tree_.assign(2 * blocks_, op_.neutral());
+  }
+
+  void build() {
+    for (size_t b = 0; b < blocks_; ++b) {
+      tree_[blocks_ + b] = reduce(b, 0, Block);
+    }
+    for (size_t v = blocks_; v-- > 1;) {
+      tree_[v] = op_(tree_[2 * v], tree_[2 * v + 1]);
+    }
+  }
+
+  // Reduces elements [from, to) of the block
+  T reduce(size_t block, size_t from, size_t to) {
+    const T* first = values_.data() + block * Block;
+
+    if constexpr (detail::kHasSimdKernel<kReduction, T>) {
+      return detail::simdReduce<kReduction, Block>(first, from, to, op_.neutral());
+    } else {
+      T result = first[from];
+      for (size_t i = from + 1; i < to; ++i) {
+        result = op_(result, first[i]);
+      }
+      return result;
+    }
+  }
+
+  [[no_unique_address]] Op op_;
+  size_t size_;
+  size_t blocks_;
+  std::vector<T> values_;
+  std::vector<T> tree_;
+};
+
+}  // namespace algo::sgt
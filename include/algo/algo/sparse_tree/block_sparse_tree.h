@@ -0,0 +1,113 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/sparse_tree/sparse_tree.h"
+#include "algo/utility/nd_container.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace algo::spt {
+
+/**
+ * @brief One-dimensional range minimum (maximum) queries in O(1) time and O(N) memory.
+ *
+ * The array is split into blocks of 64 elements. Ranges spanning several blocks are answered by
+ * a SparseTree over the block aggregates, which takes O(N / 64 * log N) memory. Inside a block,
+ * every element i keeps a bitmask of the positions j <= i which are the answer for some range [j, i]
+ * (the monotonic stack after pushing i). The answer for [l, r] is then the lowest bit of the
+ * mask of r not below l.
+ *
+ * Op must select one of its arguments, i.e. Op(a, b) == a or Op(a, b) == b (min, max, ...).
+ */
+template <typename T, typename Op>
+class BlockSparseTree : public types::StatelessEngineBase<1> {
+  using BlockTree = SparseTree<T, Op, 1>;
+
+  static constexpr size_t kBlock = 64;
+
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<1>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<1>::RangeQueryHandle;
+
+  explicit BlockSparseTree(utility::NDView<T, 1> auto view)
+      : values_(initValues(view)), masks_(values_.size()), blocks_(initBlocks()), block_handle_(blocks_.getRangeQueryHandle()) {}
+
+  T query(RangeQueryHandle& handle) {
+    size_t l = handle.getRange().left[0];
+    size_t r = handle.getRange().right[0];
+    size_t lb = l / kBlock;
+    size_t rb = r / kBlock;
+
+    if (lb == rb) {
+      return inBlock(l, r);
+    }
+
+    T result = op_(inBlock(l, lb * kBlock + kBlock - 1), inBlock(rb * kBlock, r));
+    if (lb + 1 < rb) {
+      block_handle_.getRange().left[0] = lb + 1;
+      block_handle_.getRange().right[0] = rb - 1;
+      result = op_(result, blocks_.query(block_handle_));
+    }
+    return result;
+  }
+
+ private:
+  static std::vector<T> initValues(utility::NDView<T, 1> auto view) {
+    types::Index<1> d;
+    view.getDimensions(d);
+
+    std::vector<T> values(d[0]);
+    for (size_t i = 0; i < d[0]; ++i) {
+      values[i] = view.at(i);
+    }
+    return values;
+  }
+
+  /**
+   * @brief Fills in the in-block masks and builds the tree over the block aggregates.
+   */
+  BlockTree initBlocks() {
+    std::vector<T> aggregates;
+    aggregates.reserve((values_.size() + kBlock - 1) / kBlock);
+
+    for (size_t start = 0; start < values_.size(); start += kBlock) {
+      uint64_t stack = 0;
+      size_t end = std::min(start + kBlock, values_.size());
+
+      for (size_t i = start; i < end; ++i) {
+        // Pop the positions which can not be the answer for ranges ending at i or later
+        while (stack != 0) {
+          size_t top = start + std::bit_width(stack) - 1;
+          if (!(op_(values_[top], values_[i]) == values_[i])) {
+            break;
+          }
+          stack ^= uint64_t(1) << (top - start);
+        }
+        stack |= uint64_t(1) << (i - start);
+        masks_[i] = stack;
+      }
+
+      aggregates.push_back(values_[start + std::countr_zero(masks_[end - 1])]);
+    }
+
+    return BlockTree{utility::asView(aggregates)};
+  }
+
+  T inBlock(size_t l, size_t r) const noexcept {
+    size_t start = l / kBlock * kBlock;
+    uint64_t mask = masks_[r] & (~uint64_t(0) << (l - start));
+    return values_[start + std::countr_zero(mask)];
+  }
+
+  [[no_unique_address]] Op op_;
+  std::vector<T> values_;
+  std::vector<uint64_t> masks_;
+  BlockTree blocks_;
+  typename BlockTree::RangeQueryHandle block_handle_;
+};
+
+}  // namespace algo::spt
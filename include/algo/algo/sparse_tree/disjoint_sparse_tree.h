@@ -0,0 +1,84 @@
+#pragma once
+
+#include "algo/common/types.h"
+#include "algo/utility/nd_container.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace algo::spt {
+
+/**
+ * @brief One-dimensional disjoint sparse table: O(1) range queries for any associative operation.
+ *
+ * Unlike SparseTree, Op is not required to be idempotent or commutative (sums, matrix products,
+ * hashes), since a query combines exactly two precomputed values over disjoint segments.
+ *
+ * The array is padded to the power of two P. On level k it is split into blocks of 2^(k + 1)
+ * elements, and every element stores the combination from it to the middle of its block: suffixes
+ * in the left halves, prefixes in the right halves. Elements l < r first fall into different halves
+ * of the same block on level k = bit_width(l ^ r) - 1, so the query is combine(table[k][l], table[k][r]).
+ * Takes O(P log P) memory and time to build.
+ */
+template <typename T, typename Op>
+class DisjointSparseTree : public types::StatelessEngineBase<1> {
+ public:
+  using QueryHandle = typename types::StatelessEngineBase<1>::QueryHandle;
+  using RangeQueryHandle = typename types::StatelessEngineBase<1>::RangeQueryHandle;
+
+  explicit DisjointSparseTree(utility::NDView<T, 1> auto view) {
+    types::Index<1> d;
+    view.getDimensions(d);
+    size_ = std::bit_ceil(d[0]);
+    levels_ = std::max<size_t>(1, std::bit_width(size_) - 1);
+
+    values_.assign(size_, op_.neutral());
+    for (size_t i = 0; i < d[0]; ++i) {
+      values_[i] = view.at(i);
+    }
+    storage_.assign(levels_ * size_, op_.neutral());
+    build();
+  }
+
+  T query(RangeQueryHandle& handle) {
+    size_t l = handle.getRange().left[0];
+    size_t r = handle.getRange().right[0];
+    if (l == r) {
+      return values_[l];
+    }
+
+    size_t level = std::bit_width(l ^ r) - 1;
+    const T* table = storage_.data() + level * size_;
+    return op_(table[l], table[r]);
+  }
+
+ private:
+  void build() {
+    for (size_t level = 0; level < levels_; ++level) {
+      T* table = storage_.data() + level * size_;
+      size_t half = size_t(1) << level;
+
+      for (size_t mid = half; mid < size_; mid += 2 * half) {
+        table[mid - 1] = values_[mid - 1];
+        for (size_t i = mid - 1; i-- > mid - half;) {
+          table[i] = op_(values_[i], table[i + 1]);
+        }
+
+        table[mid] = values_[mid];
+        for (size_t i = mid + 1; i < mid + half; ++i) {
+          table[i] = op_(table[i - 1], values_[i]);
+        }
+      }
+    }
+  }
+
+  [[no_unique_address]] Op op_;
+  size_t size_;
+  size_t levels_;
+  std::vector<T> values_;
+  std::vector<T> storage_;
+};
+
+}  // namespace algo::spt
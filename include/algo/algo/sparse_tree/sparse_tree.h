@@ -3,11 +3,13 @@
 #include "algo/common/types.h"
 #include "algo/utility/nd_container.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
-#include <cmath>
 #include <cstddef>
 #include <functional>
-#include <numeric>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace algo::spt {
@@ -53,7 +55,14 @@ class SparseTree {
   using QueryHandle = detail::QueryHandle<NDims>;
   using RangeQueryHandle = detail::RangeQueryHandle<NDims>;
 
-  explicit SparseTree(utility::NDView<T, NDims> auto view) {
+  explicit SparseTree(utility::NDView<T, NDims> auto view) : SparseTree(view, 1) {}
+
+  /**
+   * @brief Builds the tree using up to num_threads threads.
+   *
+   * Every level is split into equal chunks between the threads, so Op must be safe to call concurrently.
+   */
+  SparseTree(utility::NDView<T, NDims> auto view, size_t num_threads) {
     types::Index<NDims> a_dims;
     view.getDimensions(a_dims);
     std::copy(a_dims.begin(), a_dims.end(), dims_.begin());
@@ -64,8 +73,7 @@ class SparseTree {
       build_0<0>(view, idxs, 0);
     }
 
-    types::Index<1ULL << NDims> offsets{0};
-    build_q<0>(offsets, 0);
+    build(std::max<size_t>(num_threads, 1));
   }
 
   [[nodiscard]] QueryHandle getQueryHandle() const noexcept {
@@ -84,37 +92,35 @@ class SparseTree {
  private:
   template <size_t I>
   T query(RangeQueryHandle& handle) {
-    static constexpr size_t num_offsets = 1ULL << NDims;
-    static constexpr size_t step = 1ULL << I;
+    static constexpr size_t kNumOffsets = 1ULL << NDims;
 
     auto& [range, offsets] = handle;
     auto& [ql, qr] = range;
 
-    size_t l = qr[I] - ql[I] + 1;
-    size_t k = std::log2(l);
-    size_t pk = 1ULL << k;
+    size_t k = std::bit_width(qr[I] - ql[I] + 1) - 1;
+    size_t level = strides_[I + NDims] * k;
+    size_t lo = level + strides_[I] * ql[I];
+    size_t hi = level + strides_[I] * (1 + qr[I] - (1ULL << k));
 
-    {
-      size_t j = 0;
-      while (j < num_offsets) {
-        for (size_t z = 0; z < step; ++z, ++j) {
-          offsets[j] += strides_[I] * ql[I] + strides_[I + NDims] * k;
-        }
-        for (size_t z = 0; z < step; ++z, ++j) {
-          offsets[j] += strides_[I] * (1 + qr[I] - pk) + strides_[I + NDims] * k;
-        }
-      }
-    }
+    // The J-th offset takes the left or the right half along dimension I by the I-th bit of J
+    unroll<kNumOffsets>([&](auto j) { offsets[j] += (j >> I) & 1 ? hi : lo; });
 
     if constexpr (I == NDims - 1) {
-      return std::transform_reduce(
-          offsets.begin(), offsets.begin() + num_offsets, op_.neutral(), op_,
-          [this](size_t offset) { return storage_[offset]; });
+      T result = op_.neutral();
+      unroll<kNumOffsets>([&](auto j) { result = op_(result, storage_[offsets[j]]); });
+      return result;
     } else {
       return query<I + 1>(handle);
     }
   }
 
+  template <size_t N, typename F>
+  static void unroll(F&& f) {
+    [&f]<size_t... J>(std::index_sequence<J...>) {
+      (f(std::integral_constant<size_t, J>{}), ...);
+    }(std::make_index_sequence<N>{});
+  }
+
   template <size_t I>
   void build_0(utility::NDView<T, NDims> auto view, types::Index<NDims>& idxs, size_t offset) {
     for (size_t i = 0; i < dims_[I]; ++i) {
@@ -128,50 +134,88 @@ class SparseTree {
     }
   }
 
-  template <size_t I>
-  void build_q(const types::Index<1ULL << NDims>& offsets, size_t offset) {
-    static constexpr size_t kNumOffsets = 1ULL << NDims;
-    static constexpr size_t step = 1ULL << I;
-    types::Index<kNumOffsets> s_offsets;
-
-    for (size_t k = 0; k < dims_[I + NDims]; ++k) {
-      for (size_t i = 0; i + (1ULL << k) <= dims_[I]; ++i) {
-        std::copy(offsets.begin(), offsets.end(), s_offsets.begin());
-
-        if (k == 0) {
-          for (auto& offset : s_offsets) {
-            offset += strides_[I] * i;
-          }
-        } else {
-          size_t j = 0;
-          while (j < kNumOffsets) {
-            for (size_t z = 0; z < step; ++z, ++j) {
-              s_offsets[j] += strides_[I] * i + strides_[I + NDims] * (k - 1);
-            }
-            for (size_t z = 0; z < step; ++z, ++j) {
-              s_offsets[j] += strides_[I] * (i + (1ULL << (k - 1))) + strides_[I + NDims] * (k - 1);
+  /**
+   * @brief Fills the levels one dimension at a time, starting from the elements in level 0.
+   *
+   * The levels are stored one after another, each as a contiguous array of the same shape as the input.
+   * Level k along dimension I combines the element with the one 2^(k - 1) positions further along I,
+   * both taken from level k - 1 along I, which gives two sequential streams over a single level.
+   */
+  void build(size_t num_threads) {
+    for (size_t dim = 0; dim < NDims; ++dim) {
+      size_t n = dims_[dim];
+      size_t stride = strides_[dim];
+      size_t level_stride = strides_[dim + NDims];
+
+      // Levels of the previous dimensions are complete, the next ones are still 0
+      size_t levels = 1;
+      for (size_t prev = 0; prev < dim; ++prev) {
+        levels *= dims_[prev + NDims];
+      }
+      size_t rows = levels * (strides_[2 * NDims - 1] / (n * stride));
+
+      for (size_t k = 1; k < dims_[dim + NDims]; ++k) {
+        // A row is a contiguous run of all positions before dimension dim with the same prefix
+        size_t row_size = (n + 1 - (1ULL << k)) * stride;
+        size_t shift = (1ULL << (k - 1)) * stride;
+
+        auto fill = [&](size_t first, size_t last) {
+          while (first < last) {
+            size_t row = first / row_size;
+            size_t column = first % row_size;
+            size_t count = std::min(row_size - column, last - first);
+
+            size_t rows_per_level = rows / levels;
+            size_t to = levelOffset(row / rows_per_level, dim) + k * level_stride +
+                        (row % rows_per_level) * n * stride + column;
+            T* dst = storage_.data() + to;
+            const T* src = dst - level_stride;
+            for (size_t x = 0; x < count; ++x) {
+              dst[x] = op_(src[x], src[x + shift]);
             }
+            first += count;
           }
-        }
-
-        size_t new_offset = offset + i * strides_[I] + k * strides_[I + NDims];
-        if constexpr (I == NDims - 1) {
-          storage_[new_offset] = std::transform_reduce(
-              s_offsets.begin(), s_offsets.end(), op_.neutral(), op_,
-              [this](size_t offset) { return storage_[offset]; });
-        } else {
-          build_q<I + 1>(s_offsets, new_offset);
-        }
+        };
+        parallelFor(rows * row_size, num_threads, fill);
       }
     }
   }
 
+  // Offset of the level with the index in the mixed radix of the levels of dimensions [0, dim)
+  size_t levelOffset(size_t index, size_t dim) const noexcept {
+    size_t offset = 0;
+    for (size_t prev = dim; prev-- > 0;) {
+      offset += (index % dims_[prev + NDims]) * strides_[prev + NDims];
+      index /= dims_[prev + NDims];
+    }
+    return offset;
+  }
+
+  static void parallelFor(size_t size, size_t num_threads, const auto& f) {
+    static constexpr size_t kMinChunk = 1ULL << 14;
+
+    num_threads = std::min(num_threads, size / kMinChunk + 1);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < num_threads; ++t) {
+      workers.emplace_back([&f, size, num_threads, t] { f(size * t / num_threads, size * (t + 1) / num_threads); });
+    }
+    f(0, size / num_threads);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // The levels [NDims, 2 * NDims) are the outer dimensions of the storage
   void initDims() {
     for (size_t i = NDims; i < 2 * NDims; ++i) {
-      dims_[i] = 1 + std::log2(dims_[i - NDims]);
+      dims_[i] = std::bit_width(dims_[i - NDims]);
     }
     size_t stride = 1;
-    for (size_t dim = 2 * NDims; dim-- > 0;) {
+    for (size_t dim = NDims; dim-- > 0;) {
+      strides_[dim] = stride;
+      stride *= dims_[dim];
+    }
+    for (size_t dim = 2 * NDims; dim-- > NDims;) {
       strides_[dim] = stride;
       stride *= dims_[dim];
     }
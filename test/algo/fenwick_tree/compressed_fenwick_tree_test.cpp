@@ -0,0 +1,106 @@
+#include "algo/fenwick_tree/compressed_fenwick_tree.h"
+#include "algo/fenwick_tree/fenwick_tree.h"
+
+#include "test/algo/rq_utils/generate.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+
+namespace test::fwt::unit {
+
+namespace fwt = ::algo::fwt;
+
+/**
+ * @brief Random updates of a sparse set of points in a huge grid, checked against the sums over
+ * all of the updated points.
+ */
+void TestCompressedFWTSparse(size_t size, size_t count, size_t samples) {
+  std::array<size_t, 2> dims{size, size};
+  std::vector<algo::types::Index<2>> points(count);
+  for (auto& point : points) {
+    rq_utils::randomIndex(point, dims);
+  }
+
+  fwt::CompressedFenwickTree<int64_t, fwt::SumOp<int64_t>> tree{points};
+  std::map<std::pair<size_t, size_t>, int64_t> values;
+  auto handle = tree.getQueryHandle();
+  auto range_handle = tree.getRangeQueryHandle();
+
+  for (size_t sample = 0; sample < samples; ++sample) {
+    handle = points[utility::random::uniform<size_t>(0, count - 1)];
+    int64_t value = utility::random::uniform<int64_t>(-100, 100);
+    tree.update(handle, value);
+    values[{handle[0], handle[1]}] += value;
+
+    // Query around an existing point half of the time, a random range otherwise
+    auto& [ql, qr] = range_handle.getRange();
+    rq_utils::randomRange(ql, qr, dims);
+    if (sample % 2 == 0) {
+      auto& point = points[utility::random::uniform<size_t>(0, count - 1)];
+      ql = {{point[0] / 2, point[1] / 2}};
+      qr = point;
+    }
+
+    int64_t expected = 0;
+    for (auto& [point, value] : values) {
+      bool inside = ql[0] <= point.first && point.first <= qr[0] && ql[1] <= point.second && point.second <= qr[1];
+      expected += inside ? value : 0;
+    }
+    ASSERT_EQ(tree.query(range_handle), expected);
+  }
+}
+
+/**
+ * @brief With all cells of a small grid given as points, behaves exactly as the dense FenwickTree.
+ */
+void TestCompressedFWTvsFWT(size_t rows, size_t columns, size_t samples) {
+  algo::types::Index<2> dims{{rows, columns}};
+  std::vector<algo::types::Index<2>> points;
+  for (size_t x = 0; x < rows; ++x) {
+    for (size_t y = 0; y < columns; ++y) {
+      points.push_back({{x, y}});
+    }
+  }
+
+  fwt::CompressedFenwickTree<int, fwt::SumOp<int>> compressed{points};
+  fwt::FenwickTree<int, fwt::SumOp<int>, 2> dense{dims};
+  auto handle = dense.getQueryHandle();
+  auto range_handle = dense.getRangeQueryHandle();
+
+  for (size_t sample = 0; sample < samples; ++sample) {
+    rq_utils::randomIndex(handle, dims);
+    int value = utility::random::uniform(-100, 100);
+    compressed.update(handle, value);
+    dense.update(handle, value);
+
+    rq_utils::randomRange(range_handle.left, range_handle.right, dims);
+    ASSERT_EQ(compressed.query(range_handle), dense.query(range_handle));
+  }
+}
+
+TEST(CompressedFenwickTreeTest, SameAsFenwickTree) {
+  TestCompressedFWTvsFWT(1, 1, 10);
+  TestCompressedFWTvsFWT(13, 29, 1000);
+}
+
+TEST(CompressedFenwickTreeTest, Sparse) {
+  TestCompressedFWTSparse(10, 30, 1000);
+  TestCompressedFWTSparse(1'000'000, 1000, 1000);
+  TestCompressedFWTSparse(1ULL << 40, 1000, 1000);
+}
+
+#ifndef NDEBUG
+TEST(CompressedFenwickTreeTest, UpdateUnknownPoint) {
+  std::vector<algo::types::Index<2>> points{{{1, 1}}, {{3, 5}}};
+  fwt::CompressedFenwickTree<int, fwt::SumOp<int>> tree{points};
+  auto handle = tree.getQueryHandle();
+
+  handle = {{2, 5}};
+  EXPECT_DEATH(tree.update(handle, 1), "point was not passed to the constructor");
+  handle = {{3, 4}};
+  EXPECT_DEATH(tree.update(handle, 1), "point was not passed to the constructor");
+}
+#endif
+
+}  // namespace test::fwt::unit
@@ -0,0 +1,76 @@
+#include "algo/fenwick_tree/concurrent_fenwick_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace test::fwt::unit {
+
+namespace fwt = ::algo::fwt;
+
+template <size_t NDims>
+void TestConcurrentFWTvsNaive(const std::array<size_t, NDims>& dims) {
+  rq_utils::compareRangeEnginesImmutable<
+      fwt::ConcurrentFenwickTree<int, NDims>, rq_utils::NaiveRangeQueryEngine<int, rq_utils::SumOp<int>, NDims>>(
+      dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
+}
+
+TEST(ConcurrentFenwickTreeTest, Dim1) {
+  TestConcurrentFWTvsNaive<1>({10000});
+}
+TEST(ConcurrentFenwickTreeTest, Dim2) {
+  TestConcurrentFWTvsNaive<2>({73, 237});
+}
+TEST(ConcurrentFenwickTreeTest, Dim3) {
+  TestConcurrentFWTvsNaive<3>({13, 27, 49});
+}
+
+/**
+ * @brief Threads increment random cells concurrently, no increment may be lost.
+ */
+TEST(ConcurrentFenwickTreeTest, ConcurrentUpdates) {
+  constexpr size_t kSize = 1000;
+  constexpr size_t kThreads = 4;
+  constexpr size_t kUpdates = 100000;
+
+  fwt::ConcurrentFenwickTree<int64_t> tree{algo::types::Index<1>{{kSize}}};
+
+  // Indices are generated up front, the random generator is not thread-safe
+  std::vector<std::vector<size_t>> indices(kThreads, std::vector<size_t>(kUpdates));
+  std::vector<int64_t> counts(kSize, 0);
+  for (auto& thread_indices : indices) {
+    for (auto& index : thread_indices) {
+      index = utility::random::uniform<size_t>(0, kSize - 1);
+      ++counts[index];
+    }
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < kThreads; ++thread) {
+    threads.emplace_back([&, thread] {
+      auto handle = tree.getQueryHandle();
+      for (size_t index : indices[thread]) {
+        handle[0] = index;
+        tree.update(handle, 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto handle = tree.getQueryHandle();
+  int64_t prefix = 0;
+  for (size_t i = 0; i < kSize; ++i) {
+    prefix += counts[i];
+    handle[0] = i;
+    ASSERT_EQ(tree.query(handle), prefix);
+  }
+}
+
+}  // namespace test::fwt::unit
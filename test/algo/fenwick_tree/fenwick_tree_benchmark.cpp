@@ -1,5 +1,16 @@
+#include "algo/fenwick_tree/compressed_fenwick_tree.h"
+#include "algo/fenwick_tree/concurrent_fenwick_tree.h"
 #include "algo/fenwick_tree/fenwick_tree.h"
+#include "algo/fenwick_tree/range_fenwick_tree.h"
 #include "test/algo/rq_utils/benchmark.h"
+#include "test/algo/rq_utils/generate.h"
+
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 namespace test::fwt::benchmark {
 
@@ -9,6 +20,47 @@ static void BM_fenwick_tree_build(::benchmark::State& state) {
   rq_utils::rqBuildBenchmark<fwt::FenwickTree<int, fwt::SumOp<int>, 1>>(state);
 }
 
+/**
+ * @brief Builds an NDims-dimensional tree with all dimensions equal to range(0).
+ */
+template <size_t NDims>
+static void BM_fenwick_tree_build_nd(::benchmark::State& state) {
+  std::array<size_t, NDims> dims;
+  dims.fill(size_t(state.range(0)));
+  auto as = rq_utils::generate(-100, +100, dims);
+
+  for (auto _ : state) {
+    fwt::FenwickTree<int, fwt::SumOp<int>, NDims> tree{algo::utility::asView(as)};
+    ::benchmark::DoNotOptimize(tree);
+  }
+  state.SetItemsProcessed(state.iterations() * std::pow(state.range(0), NDims));
+}
+
+/**
+ * @brief Same as BM_fenwick_tree_build_nd, but inserts the values one by one in O(N log^d N).
+ */
+template <size_t NDims>
+static void BM_fenwick_tree_build_by_updates_nd(::benchmark::State& state) {
+  algo::types::Index<NDims> dims;
+  dims.fill(size_t(state.range(0)));
+  auto as = rq_utils::generate(-100, +100, std::array<size_t, NDims>(dims));
+  auto view = algo::utility::asView(as);
+  size_t size = std::pow(state.range(0), NDims);
+
+  for (auto _ : state) {
+    fwt::FenwickTree<int, fwt::SumOp<int>, NDims> tree{dims};
+    auto handle = tree.getQueryHandle();
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t dim = NDims, rest = i; dim-- > 0; rest /= dims[dim]) {
+        handle.getIndex()[dim] = rest % dims[dim];
+      }
+      tree.update(handle, view.at(handle.getIndex()));
+    }
+    ::benchmark::DoNotOptimize(tree);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
 static void BM_fenwick_tree_query(::benchmark::State& state) {
   rq_utils::rqQueryBenchmark<fwt::FenwickTree<int, fwt::SumOp<int>, 1>>(state);
 }
@@ -17,10 +69,233 @@ static void BM_fenwick_tree_update(::benchmark::State& state) {
   rq_utils::rqUpdateBenchmark<fwt::FenwickTree<int, fwt::SumOp<int>, 1>>(state);
 }
 
+template <bool BinarySearch>
+static void fenwickTreeLowerBoundBenchmark(::benchmark::State& state) {
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate(0, 100, dims);
+  fwt::FenwickTree<int, fwt::SumOp<int>, 1> tree{algo::utility::asView(as)};
+  auto handle = tree.getQueryHandle();
+  int total = std::accumulate(as.begin(), as.end(), 0);
+
+  // Pre-generated, pausing the timer costs more than the search itself
+  std::vector<int> values(1024);
+  for (auto& value : values) {
+    value = utility::random::uniform(0, total);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    int value = values[i++ % values.size()];
+
+    if constexpr (BinarySearch) {
+      size_t l = 0, r = dims[0];
+      while (l < r) {
+        handle[0] = (l + r) / 2;
+        if (tree.query(handle) < value) {
+          l = handle[0] + 1;
+        } else {
+          r = handle[0];
+        }
+      }
+      ::benchmark::DoNotOptimize(l);
+    } else {
+      ::benchmark::DoNotOptimize(tree.lowerBound(value));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static void BM_fenwick_tree_lower_bound(::benchmark::State& state) {
+  fenwickTreeLowerBoundBenchmark<false>(state);
+}
+
+static void BM_fenwick_tree_lower_bound_binary_search(::benchmark::State& state) {
+  fenwickTreeLowerBoundBenchmark<true>(state);
+}
+
+/**
+ * @brief Applies range(1) random point updates to a tree of size range(0), one by one or as a batch.
+ */
+template <bool Batch>
+static void fenwickTreeUpdateBurstBenchmark(::benchmark::State& state) {
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate(-100, +100, dims);
+  fwt::FenwickTree<int, fwt::SumOp<int>, 1> tree{algo::utility::asView(as)};
+
+  std::vector<std::pair<algo::types::Index<1>, int>> updates(state.range(1));
+  for (auto& [index, value] : updates) {
+    rq_utils::randomIndex(index, dims);
+    value = utility::random::uniform(-100, 100);
+  }
+
+  for (auto _ : state) {
+    if constexpr (Batch) {
+      tree.updateBatch(updates);
+    } else {
+      for (auto& [index, value] : updates) {
+        tree.update(index, value);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * updates.size());
+}
+
+static void BM_fenwick_tree_update_burst(::benchmark::State& state) {
+  fenwickTreeUpdateBurstBenchmark<false>(state);
+}
+
+static void BM_fenwick_tree_update_batch(::benchmark::State& state) {
+  fenwickTreeUpdateBurstBenchmark<true>(state);
+}
+
+/**
+ * @brief range(0) random points in a 10^6 x 10^6 grid.
+ */
+static std::vector<algo::types::Index<2>> generateSparsePoints(::benchmark::State& state) {
+  std::array<size_t, 2> dims = {1'000'000, 1'000'000};
+  std::vector<algo::types::Index<2>> points(state.range(0));
+  for (auto& point : points) {
+    rq_utils::randomIndex(point, dims);
+  }
+  return points;
+}
+
+static void BM_compressed_fenwick_tree_build(::benchmark::State& state) {
+  auto points = generateSparsePoints(state);
+  for (auto _ : state) {
+    fwt::CompressedFenwickTree<int64_t, fwt::SumOp<int64_t>> tree{points};
+    ::benchmark::DoNotOptimize(tree);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static void BM_compressed_fenwick_tree_update(::benchmark::State& state) {
+  auto points = generateSparsePoints(state);
+  fwt::CompressedFenwickTree<int64_t, fwt::SumOp<int64_t>> tree{points};
+  size_t i = 0;
+
+  for (auto _ : state) {
+    tree.update(points[i++ % points.size()], 1);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static void BM_compressed_fenwick_tree_query(::benchmark::State& state) {
+  auto points = generateSparsePoints(state);
+  fwt::CompressedFenwickTree<int64_t, fwt::SumOp<int64_t>> tree{points};
+  auto handle = tree.getRangeQueryHandle();
+  size_t i = 0;
+
+  for (auto _ : state) {
+    handle.left = points[i++ % points.size()];
+    handle.right = points[i++ % points.size()];
+    for (size_t dim = 0; dim < 2; ++dim) {
+      if (handle.left[dim] > handle.right[dim]) {
+        std::swap(handle.left[dim], handle.right[dim]);
+      }
+    }
+    ::benchmark::DoNotOptimize(tree.query(handle));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static constexpr size_t kSharedTreeSize = 1ULL << 20;
+static constexpr size_t kSharedIndices = 1ULL << 12;
+
+/**
+ * @brief Tree and update indices shared by all threads of a benchmark, indices are generated up front
+ * since the random generator is not thread-safe.
+ */
+template <typename Tree>
+struct SharedTree {
+  static SharedTree& instance() {
+    static SharedTree shared;
+    return shared;
+  }
+
+  Tree tree{algo::types::Index<1>{{kSharedTreeSize}}};
+  std::vector<size_t> indices = [] {
+    std::vector<size_t> indices(kSharedIndices);
+    for (auto& index : indices) {
+      index = utility::random::uniform<size_t>(0, kSharedTreeSize - 1);
+    }
+    return indices;
+  }();
+  std::mutex mutex;
+};
+
+template <typename Tree, typename Update>
+static void fenwickTreeSharedUpdateBenchmark(::benchmark::State& state, const Update& update) {
+  auto& shared = SharedTree<Tree>::instance();
+  auto handle = shared.tree.getQueryHandle();
+  size_t i = state.thread_index() * kSharedIndices / 8;
+
+  for (auto _ : state) {
+    handle[0] = shared.indices[i++ % kSharedIndices];
+    update(shared, handle);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_concurrent_fenwick_tree_update(::benchmark::State& state) {
+  fenwickTreeSharedUpdateBenchmark<fwt::ConcurrentFenwickTree<int64_t>>(
+      state, [](auto& shared, auto& handle) { shared.tree.update(handle, 1); });
+}
+
+static void BM_mutex_fenwick_tree_update(::benchmark::State& state) {
+  fenwickTreeSharedUpdateBenchmark<fwt::FenwickTree<int64_t, fwt::SumOp<int64_t>>>(
+      state, [](auto& shared, auto& handle) {
+        std::lock_guard lock(shared.mutex);
+        shared.tree.update(handle, 1);
+      });
+}
+
+static void BM_range_fenwick_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<fwt::RangeFenwickTree<int, 1>>(state);
+}
+
+static void BM_range_fenwick_tree_update_range(::benchmark::State& state) {
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate(-100, +100, dims);
+  fwt::RangeFenwickTree<int, 1> tree{algo::utility::asView(as)};
+  auto handle = tree.getRangeQueryHandle();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    rq_utils::randomRange(handle.getRange().left, handle.getRange().right, dims);
+    state.ResumeTiming();
+
+    tree.updateRange(handle, 1);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 BENCHMARK(BM_fenwick_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_fenwick_tree_build_nd<1>)->RangeMultiplier(16)->Range(1ULL << 8, 1ULL << 20);
+BENCHMARK(BM_fenwick_tree_build_nd<2>)->RangeMultiplier(4)->Range(1ULL << 4, 1ULL << 10);
+BENCHMARK(BM_fenwick_tree_build_nd<3>)->RangeMultiplier(2)->Range(1ULL << 3, 1ULL << 7);
+BENCHMARK(BM_fenwick_tree_build_by_updates_nd<1>)->RangeMultiplier(16)->Range(1ULL << 8, 1ULL << 20);
+BENCHMARK(BM_fenwick_tree_build_by_updates_nd<2>)->RangeMultiplier(4)->Range(1ULL << 4, 1ULL << 10);
+BENCHMARK(BM_fenwick_tree_build_by_updates_nd<3>)->RangeMultiplier(2)->Range(1ULL << 3, 1ULL << 7);
 BENCHMARK(BM_fenwick_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 BENCHMARK(BM_fenwick_tree_update)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 
+BENCHMARK(BM_fenwick_tree_lower_bound)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 22)->Complexity();
+BENCHMARK(BM_fenwick_tree_lower_bound_binary_search)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 22)->Complexity();
+
+BENCHMARK(BM_fenwick_tree_update_burst)->ArgsProduct({{1 << 20}, {1 << 12, 1 << 15, 1 << 16, 100'000, 1 << 20}});
+BENCHMARK(BM_fenwick_tree_update_batch)->ArgsProduct({{1 << 20}, {1 << 12, 1 << 15, 1 << 16, 100'000, 1 << 20}});
+
+BENCHMARK(BM_compressed_fenwick_tree_build)->RangeMultiplier(4)->Range(1ULL << 8, 1ULL << 18)->Complexity();
+BENCHMARK(BM_compressed_fenwick_tree_update)->RangeMultiplier(4)->Range(1ULL << 8, 1ULL << 18)->Complexity();
+BENCHMARK(BM_compressed_fenwick_tree_query)->RangeMultiplier(4)->Range(1ULL << 8, 1ULL << 18)->Complexity();
+
+BENCHMARK(BM_concurrent_fenwick_tree_update)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_mutex_fenwick_tree_update)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_range_fenwick_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_range_fenwick_tree_update_range)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+
 }  // namespace test::fwt::benchmark
 
 BENCHMARK_MAIN();
\ No newline at end of file
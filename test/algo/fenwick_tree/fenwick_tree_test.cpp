@@ -5,7 +5,11 @@
 #include "test/algo/rq_utils/range_query.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
 #include <random>
+#include <utility>
+#include <vector>
 
 namespace test::fwt::unit {
 
@@ -18,6 +22,74 @@ void TestFWTvsNaive(const std::array<size_t, NDims>& dims) {
       dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
 }
 
+/**
+ * @brief The linear-time build must produce the same tree as inserting the values one by one.
+ */
+template <size_t NDims>
+void TestFWTBuildvsUpdates(const std::array<size_t, NDims>& dims) {
+  using Tree = fwt::FenwickTree<int, fwt::MinOp<int>, NDims>;
+  auto as = rq_utils::generate(-100, +100, dims);
+  Tree built{algo::utility::asView(as)};
+  Tree updated{algo::types::Index<NDims>{dims}};
+
+  auto handle = updated.getQueryHandle();
+  size_t size = std::accumulate(dims.begin(), dims.end(), size_t(1), std::multiplies<size_t>());
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t dim = NDims, rest = i; dim-- > 0; rest /= dims[dim]) {
+      handle.getIndex()[dim] = rest % dims[dim];
+    }
+    updated.update(handle, algo::utility::asView(as).at(handle.getIndex()));
+  }
+
+  for (size_t sample = 0; sample < 1000; ++sample) {
+    rq_utils::randomIndex(handle.getIndex(), dims);
+    ASSERT_EQ(built.query(handle), updated.query(handle));
+  }
+}
+
+/**
+ * @brief updateBatch must give the same tree as applying the updates one by one, both for the sparse
+ * and the dense (linear rebuild) batches.
+ */
+template <template <typename> typename Op, size_t NDims>
+void TestFWTBatchvsUpdates(const std::array<size_t, NDims>& dims, size_t count) {
+  using Tree = fwt::FenwickTree<int, Op<int>, NDims>;
+  auto as = rq_utils::generate(-100, +100, dims);
+  Tree batched{algo::utility::asView(as)};
+  Tree updated{algo::utility::asView(as)};
+
+  std::vector<std::pair<algo::types::Index<NDims>, int>> updates(count);
+  for (auto& [index, value] : updates) {
+    rq_utils::randomIndex(index, dims);
+    value = utility::random::uniform(-100, 100);
+    updated.update(index, value);
+  }
+  batched.updateBatch(updates);
+
+  auto handle = updated.getQueryHandle();
+  for (size_t sample = 0; sample < 1000; ++sample) {
+    rq_utils::randomIndex(handle.getIndex(), dims);
+    ASSERT_EQ(batched.query(handle), updated.query(handle));
+  }
+}
+
+/**
+ * @brief Checks lowerBound against a linear scan over the prefix sums of non-negative values.
+ */
+void TestFWTLowerBound(size_t size) {
+  std::array<size_t, 1> dims{size};
+  auto as = rq_utils::generate(0, 10, dims);
+  fwt::FenwickTree<int, fwt::SumOp<int>, 1> tree{algo::utility::asView(as)};
+
+  std::vector<int> prefix(size);
+  std::partial_sum(as.begin(), as.end(), prefix.begin());
+
+  for (int value = -1; value <= prefix.back() + 1; ++value) {
+    size_t expected = std::lower_bound(prefix.begin(), prefix.end(), value) - prefix.begin();
+    ASSERT_EQ(tree.lowerBound(value), expected);
+  }
+}
+
 TEST(FenwickTreeTest, Dim1) {
   TestFWTvsNaive<1>({10000});
 }
@@ -31,4 +103,26 @@ TEST(FenwickTreeTest, Dim4) {
   TestFWTvsNaive<4>({9, 13, 21, 17});
 }
 
+TEST(FenwickTreeTest, LinearBuild) {
+  TestFWTBuildvsUpdates<1>({1000});
+  TestFWTBuildvsUpdates<2>({37, 53});
+  TestFWTBuildvsUpdates<3>({13, 7, 29});
+}
+
+TEST(FenwickTreeTest, UpdateBatch) {
+  for (size_t count : {0, 1, 10, 100, 10000}) {
+    TestFWTBatchvsUpdates<fwt::SumOp, 1>({1000}, count);
+    TestFWTBatchvsUpdates<fwt::MinOp, 1>({1000}, count);
+    TestFWTBatchvsUpdates<fwt::SumOp, 2>({37, 53}, count);
+    TestFWTBatchvsUpdates<fwt::MaxOp, 3>({13, 7, 29}, count);
+  }
+}
+
+TEST(FenwickTreeTest, LowerBound) {
+  TestFWTLowerBound(1);
+  TestFWTLowerBound(13);
+  TestFWTLowerBound(1024);
+  TestFWTLowerBound(1000);
+}
+
 }  // namespace test::fwt::unit
@@ -0,0 +1,51 @@
+#include "algo/fenwick_tree/range_fenwick_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+
+#include <gtest/gtest.h>
+
+namespace test::fwt::unit {
+
+namespace fwt = ::algo::fwt;
+
+template <size_t NDims>
+void TestRangeFWTvsNaive(const std::array<size_t, NDims>& dims) {
+  rq_utils::compareRangeEnginesMutableRange<
+      fwt::RangeFenwickTree<int64_t, NDims>, rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, NDims>,
+      int64_t, int64_t>(dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
+}
+
+TEST(RangeFenwickTreeTest, Dim1) {
+  TestRangeFWTvsNaive<1>({1});
+  TestRangeFWTvsNaive<1>({13});
+  TestRangeFWTvsNaive<1>({10000});
+}
+TEST(RangeFenwickTreeTest, Dim2) {
+  TestRangeFWTvsNaive<2>({1, 1});
+  TestRangeFWTvsNaive<2>({73, 37});
+}
+TEST(RangeFenwickTreeTest, Dim3) {
+  TestRangeFWTvsNaive<3>({13, 7, 19});
+}
+TEST(RangeFenwickTreeTest, Dim4) {
+  TestRangeFWTvsNaive<4>({5, 9, 3, 7});
+}
+
+TEST(RangeFenwickTreeTest, PointUpdateAndPrefix) {
+  algo::types::Index<2> dims{{4, 5}};
+  fwt::RangeFenwickTree<int, 2> tree{dims};
+  auto handle = tree.getQueryHandle();
+
+  handle.getIndex() = algo::types::Index<2>{{1, 2}};
+  tree.update(handle, 3);
+  handle.getIndex() = algo::types::Index<2>{{3, 4}};
+  tree.update(handle, 5);
+  ASSERT_EQ(tree.query(handle), 8);
+
+  handle.getIndex() = algo::types::Index<2>{{3, 1}};
+  ASSERT_EQ(tree.query(handle), 0);
+}
+
+}  // namespace test::fwt::unit
@@ -0,0 +1,91 @@
+#include "algo/kdtree/dynamic_kdtree.h"
+
+#include "test/algo/kdtree/naive_kdtree.h"
+#include "test/algo/rq_utils/generate.h"
+
+#include <gtest/gtest.h>
+
+namespace test::kdtree::unit {
+
+namespace kdtree = ::algo::kdtree;
+
+/**
+ * @brief Inserts and erases random points, some of them repeatedly, and compares the queries to the naive search.
+ */
+template <size_t Dims>
+void dynamicKDTreeTest(size_t initial_count, size_t num_updates, size_t query_period) {
+  using PointType = std::array<int, Dims>;
+  using DistanceFunctor = kdtree::EuclideanDistance<PointType>;
+
+  std::vector<PointType> points = rq_utils::generatePoints<Dims>(initial_count);
+  kdtree::DynamicKDTree<PointType, Dims, DistanceFunctor> tree(points);
+
+  PointType q;
+  for (size_t update = 0; update < num_updates; ++update) {
+    size_t action = utility::random::uniform(0, 2);
+    if (action == 0 && !points.empty()) {
+      // Erase an existing point
+      size_t i = utility::random::uniform(size_t{0}, points.size() - 1);
+      EXPECT_TRUE(tree.erase(points[i]));
+      std::swap(points[i], points.back());
+      points.pop_back();
+    } else if (action == 1 && !points.empty()) {
+      // Insert a duplicate of an existing point
+      points.push_back(points[utility::random::uniform(size_t{0}, points.size() - 1)]);
+      tree.insert(points.back());
+    } else {
+      rq_utils::generatePoint(q);
+      points.push_back(q);
+      tree.insert(q);
+    }
+    ASSERT_EQ(tree.size(), points.size());
+
+    if (update % query_period != 0 || points.empty()) {
+      continue;
+    }
+
+    NaiveKDTree<PointType, Dims, DistanceFunctor> naive_tree(points);
+    rq_utils::generatePoint(q);
+    size_t k = utility::random::uniform(size_t{0}, points.size());
+    uint64_t radius = utility::random::uniform(0, 1000);
+
+    verifySameDistances<PointType, DistanceFunctor>(q, tree.nnSearch(q), naive_tree.nnSearch(q));
+    verifySameDistances<PointType, DistanceFunctor>(q, tree.knnSearch(q, k), naive_tree.knnSearch(q, k));
+    verifySameDistances<PointType, DistanceFunctor>(q, tree.radiusSearch(q, radius), naive_tree.radiusSearch(q, radius));
+  }
+}
+
+TEST(DynamicKDTreeTest, Empty) {
+  kdtree::DynamicKDTree<std::array<int, 2>, 2> tree;
+  EXPECT_TRUE(tree.empty());
+  EXPECT_FALSE(tree.erase({0, 0}));
+  EXPECT_TRUE(tree.radiusSearch({0, 0}, 1000).empty());
+
+  tree.insert({1, 2});
+  EXPECT_EQ(tree.nnSearch({0, 0}), (std::array<int, 2>{1, 2}));
+  EXPECT_FALSE(tree.erase({2, 1}));
+  EXPECT_TRUE(tree.erase({1, 2}));
+  EXPECT_TRUE(tree.empty());
+}
+
+TEST(DynamicKDTreeTest, InsertOnly) {
+  kdtree::DynamicKDTree<std::array<int, 2>, 2> tree;
+  for (int i = 0; i < 10000; ++i) {
+    tree.insert({i, i});
+  }
+  EXPECT_EQ(tree.size(), 10000);
+  EXPECT_EQ(tree.nnSearch({5000, 5001}), (std::array<int, 2>{5000, 5000}));
+}
+
+TEST(DynamicKDTreeTest, Random2D) {
+  dynamicKDTreeTest<2>(0, 20000, 10);
+  dynamicKDTreeTest<2>(1000, 20000, 10);
+}
+TEST(DynamicKDTreeTest, Random3D) {
+  dynamicKDTreeTest<3>(1000, 20000, 10);
+}
+TEST(DynamicKDTreeTest, Random5D) {
+  dynamicKDTreeTest<5>(1000, 20000, 10);
+}
+
+}  // namespace test::kdtree::unit
@@ -1,7 +1,10 @@
+#include "algo/kdtree/dynamic_kdtree.h"
 #include "algo/kdtree/kdtree.h"
 #include "test/algo/rq_utils/generate.h"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
+#include <vector>
 
 namespace test::kdtree::benchmark {
 
@@ -20,19 +23,46 @@ static void BM_kdtree_build(::benchmark::State& state) {
   state.SetComplexityN(state.range());
 }
 
-template <size_t Dims, typename BenchmarkedOperation, typename ArgsGenerator>
-static void kdtreeGenericBenchmark(::benchmark::State& state, BenchmarkedOperation operation, ArgsGenerator generator) {
-  auto points = rq_utils::generatePoints<Dims>(state.range());
-  kdtree::KDTree<std::array<int, Dims>, Dims> tree{points};
-  std::array<int, Dims> q;
+/**
+ * @brief Builds a tree of range(0) points with range(1) threads.
+ */
+template <size_t Dims>
+static void BM_kdtree_parallel_build(::benchmark::State& state) {
+  auto points = rq_utils::generatePoints<Dims>(state.range(0));
 
   for (auto _ : state) {
     state.PauseTiming();
-    rq_utils::generatePoint(q);
-    const auto args_tuple = generator();
+    auto copy = points;
     state.ResumeTiming();
 
-    std::apply([&](auto... args) { ::benchmark::DoNotOptimize(operation(tree, q, args...)); }, args_tuple);
+    kdtree::KDTree<std::array<int, Dims>, Dims> tree{std::move(copy), size_t(state.range(1))};
+    ::benchmark::DoNotOptimize(tree);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Runs the operation on a tree of range(0) points. The queries are generated in advance, so that
+ * the timing is not paused on every query.
+ */
+template <
+    size_t Dims, typename Tree = kdtree::KDTree<std::array<int, Dims>, Dims>, typename BenchmarkedOperation,
+    typename ArgsGenerator>
+static void kdtreeGenericBenchmark(::benchmark::State& state, BenchmarkedOperation operation, ArgsGenerator generator) {
+  static constexpr size_t kQueries = 1024;
+
+  auto points = rq_utils::generatePoints<Dims>(state.range());
+  Tree tree{points};
+
+  auto queries = rq_utils::generatePoints<Dims>(kQueries);
+  std::vector<decltype(generator())> args(kQueries);
+  std::generate(args.begin(), args.end(), generator);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto& q = queries[i % kQueries];
+    std::apply([&](auto... args) { ::benchmark::DoNotOptimize(operation(tree, q, args...)); }, args[i % kQueries]);
+    ++i;
   }
 
   state.SetComplexityN(state.range());
@@ -54,6 +84,129 @@ static void BM_kdtree_knn_search(::benchmark::State& state) {
       [] { return std::tuple<>{}; });
 }
 
+/**
+ * @brief Same as BM_kdtree_knn_search, but with leaves of LeafSize points.
+ */
+template <size_t Dims, size_t K, size_t LeafSize>
+static void BM_kdtree_knn_search_leaf(::benchmark::State& state) {
+  using PointType = std::array<int, Dims>;
+  kdtreeGenericBenchmark<Dims, kdtree::KDTree<PointType, Dims, kdtree::EuclideanDistance<PointType>, LeafSize>>(
+      state,                                                           //
+      [](auto& tree, const auto& q) { return tree.knnSearch(q, K); },  //
+      [] { return std::tuple<>{}; });
+}
+
+static constexpr size_t kBatchSize = 1ULL << 14;
+
+/**
+ * @brief Answers kBatchSize k-NN queries on a tree of range(0) points by calling knnSearch for each of them.
+ */
+template <size_t Dims, size_t K>
+static void BM_kdtree_knn_search_loop(::benchmark::State& state) {
+  kdtree::KDTree<std::array<int, Dims>, Dims> tree{rq_utils::generatePoints<Dims>(state.range(0))};
+  auto queries = rq_utils::generatePoints<Dims>(kBatchSize);
+
+  for (auto _ : state) {
+    for (const auto& q : queries) {
+      ::benchmark::DoNotOptimize(tree.knnSearch(q, K));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/**
+ * @brief Same as BM_kdtree_knn_search_loop, but with a single knnSearchBatch call on range(1) threads.
+ */
+template <size_t Dims, size_t K>
+static void BM_kdtree_knn_search_batch(::benchmark::State& state) {
+  kdtree::KDTree<std::array<int, Dims>, Dims> tree{rq_utils::generatePoints<Dims>(state.range(0))};
+  auto queries = rq_utils::generatePoints<Dims>(kBatchSize);
+  std::vector<std::array<int, Dims>> output(kBatchSize * K);
+
+  for (auto _ : state) {
+    tree.knnSearchBatch(queries, K, output, state.range(1));
+    ::benchmark::DoNotOptimize(output.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/**
+ * @brief Inserts range(0) points one by one into an empty DynamicKDTree.
+ */
+template <size_t Dims>
+static void BM_dynamic_kdtree_insert(::benchmark::State& state) {
+  auto points = rq_utils::generatePoints<Dims>(state.range(0));
+
+  for (auto _ : state) {
+    kdtree::DynamicKDTree<std::array<int, Dims>, Dims> tree;
+    for (const auto& p : points) {
+      tree.insert(p);
+    }
+    ::benchmark::DoNotOptimize(tree);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Fills a DynamicKDTree with size points by insertions, then replaces 3/4 of them one by one, the oldest
+ * first. This stops halfway between two full rebuilds of the tree.
+ */
+template <size_t Dims>
+static auto churnedDynamicKDTree(size_t size) {
+  const size_t replaced = size * 3 / 4;
+  auto points = rq_utils::generatePoints<Dims>(size + replaced);
+  kdtree::DynamicKDTree<std::array<int, Dims>, Dims> tree;
+  for (size_t i = 0; i < size; ++i) {
+    tree.insert(points[i]);
+  }
+  for (size_t i = size; i < size + replaced; ++i) {
+    tree.erase(points[i - size]);
+    tree.insert(points[i]);
+  }
+  return tree;
+}
+
+/**
+ * @brief Measures an erase and an insert on a tree of range(0) points after churnedDynamicKDTree.
+ */
+template <size_t Dims>
+static void BM_dynamic_kdtree_churn(::benchmark::State& state) {
+  static constexpr size_t kUpdates = 1ULL << 16;
+
+  size_t size = state.range(0);
+  auto tree = churnedDynamicKDTree<Dims>(size);
+  auto points = tree.radiusSearch({}, 1ULL << 20);
+  auto updates = rq_utils::generatePoints<Dims>(kUpdates);
+
+  // Every update replaces the oldest point, points is used as a ring buffer
+  size_t i = 0;
+  for (auto _ : state) {
+    auto& oldest = points[i % points.size()];
+    tree.erase(oldest);
+    oldest = updates[i % kUpdates];
+    tree.insert(oldest);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Same as BM_kdtree_knn_search_large, but on a DynamicKDTree after churnedDynamicKDTree.
+ */
+template <size_t Dims, size_t K>
+static void BM_dynamic_kdtree_knn_search(::benchmark::State& state) {
+  static constexpr size_t kQueries = 1024;
+
+  auto tree = churnedDynamicKDTree<Dims>(state.range(0));
+  auto queries = rq_utils::generatePoints<Dims>(kQueries);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(tree.knnSearch(queries[i++ % kQueries], K));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
 template <size_t Dims, uint64_t Radius>
 static void BM_kdtree_radius_search(::benchmark::State& state) {
   kdtreeGenericBenchmark<Dims>(
@@ -63,6 +216,7 @@ static void BM_kdtree_radius_search(::benchmark::State& state) {
 }
 
 static constexpr size_t kMaxTreeSize = 1ULL << 14;
+static constexpr size_t kMaxLargeTreeSize = 1ULL << 22;
 
 BENCHMARK(BM_kdtree_build<2>)->RangeMultiplier(2)->Range(1, kMaxTreeSize)->Complexity();
 BENCHMARK(BM_kdtree_build<3>)->RangeMultiplier(2)->Range(1, kMaxTreeSize)->Complexity();
@@ -81,6 +235,38 @@ BENCHMARK(BM_kdtree_radius_search<2, 10>)->RangeMultiplier(2)->Range(1, kMaxTree
 BENCHMARK(BM_kdtree_radius_search<2, 100>)->RangeMultiplier(2)->Range(1, kMaxTreeSize)->Complexity();
 BENCHMARK(BM_kdtree_radius_search<2, 1000>)->RangeMultiplier(2)->Range(1, kMaxTreeSize)->Complexity();
 
+BENCHMARK(BM_kdtree_knn_search_leaf<3, 8, 1>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<3, 8, 16>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<3, 8, 32>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<3, 8, 64>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<8, 8, 1>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<8, 8, 16>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<8, 8, 32>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_leaf<8, 8, 64>)->Arg(1ULL << 20);
+
+BENCHMARK(BM_kdtree_parallel_build<3>)
+    ->ArgsProduct({{1ULL << 20, 1ULL << 22}, ::benchmark::CreateDenseRange(1, 8, 1)})
+    ->UseRealTime();
+
+BENCHMARK(BM_kdtree_knn_search_loop<3, 8>)->Arg(1ULL << 20);
+BENCHMARK(BM_kdtree_knn_search_batch<3, 8>)
+    ->ArgsProduct({{1ULL << 20}, ::benchmark::CreateDenseRange(1, 8, 1)})
+    ->UseRealTime();
+
+BENCHMARK(BM_kdtree_build<3>)->Name("BM_kdtree_build_large<3>")->RangeMultiplier(4)->Range(kMaxTreeSize, kMaxLargeTreeSize);
+BENCHMARK(BM_kdtree_nn_search<3>)
+    ->Name("BM_kdtree_nn_search_large<3>")
+    ->RangeMultiplier(4)
+    ->Range(kMaxTreeSize, kMaxLargeTreeSize);
+BENCHMARK(BM_kdtree_knn_search<3, 8>)
+    ->Name("BM_kdtree_knn_search_large<3, 8>")
+    ->RangeMultiplier(4)
+    ->Range(kMaxTreeSize, kMaxLargeTreeSize);
+
+BENCHMARK(BM_dynamic_kdtree_insert<3>)->RangeMultiplier(16)->Range(kMaxTreeSize, kMaxLargeTreeSize);
+BENCHMARK(BM_dynamic_kdtree_churn<3>)->RangeMultiplier(16)->Range(kMaxTreeSize, kMaxLargeTreeSize);
+BENCHMARK(BM_dynamic_kdtree_knn_search<3, 8>)->RangeMultiplier(16)->Range(kMaxTreeSize, kMaxLargeTreeSize);
+
 }  // namespace test::kdtree::benchmark
 
 BENCHMARK_MAIN();
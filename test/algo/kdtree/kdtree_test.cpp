@@ -1,5 +1,6 @@
 #include "algo/kdtree/kdtree.h"
 
+#include "test/algo/kdtree/naive_kdtree.h"
 #include "test/algo/rq_utils/generate.h"
 
 #include <gtest/gtest.h>
@@ -9,67 +10,16 @@ namespace test::kdtree::unit {
 
 namespace kdtree = ::algo::kdtree;
 
-template <typename PointType, size_t Dims, typename DistanceBinaryFunctor = kdtree::EuclideanDistance<PointType>>
-class NaiveKDTree {
- public:
-  explicit NaiveKDTree(std::vector<PointType> points) noexcept : points_{std::move(points)} {}
-
-  const PointType& nnSearch(const PointType& q) {
-    return *std::min_element(points_.begin(), points_.end(), [&q, this](const auto& a, const auto& b) {
-      return distance_(a, q) < distance_(b, q);
-    });
-  }
-
-  std::vector<PointType> knnSearch(const PointType& q, size_t max_count) {
-    std::sort(points_.begin(), points_.end(), [&q, this](const auto& a, const auto& b) {
-      return distance_(a, q) < distance_(b, q);
-    });
-    return {points_.begin(), points_.begin() + std::min(max_count, points_.size())};
-  }
-
-  std::vector<PointType> radiusSearch(const PointType& q, uint64_t radius) {
-    radius *= radius;
-    std::vector<PointType> output;
-    std::copy_if(points_.begin(), points_.end(), std::back_inserter(output), [&q, radius, this](const PointType& p) {
-      return distance_(q, p) < radius;
-    });
-    return output;
-  }
-
- private:
-  [[no_unique_address]] DistanceBinaryFunctor distance_;
-  std::vector<PointType> points_;
-};
-
-template <typename PointType, typename DistanceBinaryFunctor>
-void verifySameDistances(const PointType& to, const PointType& a, const PointType& b) {
-  DistanceBinaryFunctor distance;
-  EXPECT_EQ(distance(to, a), distance(to, b));
-}
-
-template <typename PointType, typename DistanceBinaryFunctor>
-void verifySameDistances(const PointType& to, const std::vector<PointType>& p1, const std::vector<PointType>& p2) {
-  std::vector<uint64_t> p1d;
-  std::vector<uint64_t> p2d;
-  p1d.reserve(p1.size());
-  p2d.reserve(p2.size());
-
-  DistanceBinaryFunctor distance;
-  std::transform(p1.begin(), p1.end(), std::back_inserter(p1d), [&](const auto& a) { return distance(a, to); });
-  std::transform(p2.begin(), p2.end(), std::back_inserter(p2d), [&](const auto& a) { return distance(a, to); });
-
-  std::sort(p1d.begin(), p1d.end());
-  std::sort(p2d.begin(), p2d.end());
-  EXPECT_EQ(p1d, p2d);
-}
-
 template <size_t Dims, typename TestOperation, typename ArgsGenerator>
 void kdtreeGenericTest(std::vector<std::array<int, Dims>> points, TestOperation operation, ArgsGenerator generator) {
   using PointType = std::array<int, Dims>;
   using DistanceFunctor = kdtree::EuclideanDistance<PointType>;
   static constexpr int kNumTrials = 10000;
 
+  // Single-point leaves, the default leaves and leaves that may be scanned partially by the vector kernel
+  kdtree::KDTree<PointType, Dims, DistanceFunctor, 1> kdtree_1(points);
   kdtree::KDTree<PointType, Dims, DistanceFunctor> kdtree(points);
+  kdtree::KDTree<PointType, Dims, DistanceFunctor, 7> kdtree_7(points);
   NaiveKDTree<PointType, Dims, DistanceFunctor> naive_tree(points);
 
   PointType q;
@@ -77,8 +27,10 @@ void kdtreeGenericTest(std::vector<std::array<int, Dims>> points, TestOperation
     rq_utils::generatePoint(q);
     std::apply(
         [&](auto... args) {
-          verifySameDistances<PointType, DistanceFunctor>(
-              q, operation(kdtree, q, args...), operation(kdtree, q, args...));
+          auto expected = operation(naive_tree, q, args...);
+          verifySameDistances<PointType, DistanceFunctor>(q, operation(kdtree_1, q, args...), expected);
+          verifySameDistances<PointType, DistanceFunctor>(q, operation(kdtree, q, args...), expected);
+          verifySameDistances<PointType, DistanceFunctor>(q, operation(kdtree_7, q, args...), expected);
         },
         generator());
   }
@@ -94,10 +46,11 @@ void nnSearchTest(std::vector<std::array<int, Dims>> points) {
 
 template <size_t Dims>
 void knnSearchTest(std::vector<std::array<int, Dims>> points) {
+  const size_t point_count = points.size();
   kdtreeGenericTest(
       std::move(points),  //
       [](auto& tree, const auto& q, size_t max_count) { return tree.knnSearch(q, max_count); },
-      [point_count = points.size()] { return std::tuple<size_t>{utility::random::uniform(size_t{0}, point_count)}; });
+      [point_count] { return std::tuple<size_t>{utility::random::uniform(size_t{0}, point_count)}; });
 }
 
 template <size_t Dims>
@@ -123,6 +76,43 @@ void radiusSearchTest(size_t point_count) {
   radiusSearchTest(rq_utils::generatePoints<Dims>(point_count));
 }
 
+template <size_t Dims>
+void knnSearchBatchTest(size_t point_count, size_t k, size_t num_threads) {
+  using PointType = std::array<int, Dims>;
+  using DistanceFunctor = kdtree::EuclideanDistance<PointType>;
+  static constexpr size_t kNumQueries = 1000;
+
+  kdtree::KDTree<PointType, Dims, DistanceFunctor> kdtree(rq_utils::generatePoints<Dims>(point_count));
+  auto queries = rq_utils::generatePoints<Dims>(kNumQueries);
+  std::vector<PointType> output(kNumQueries * k);
+  kdtree.knnSearchBatch(queries, k, output, num_threads);
+
+  DistanceFunctor distance;
+  for (size_t i = 0; i < kNumQueries; ++i) {
+    std::vector<PointType> neighbours(output.begin() + i * k, output.begin() + (i + 1) * k);
+    verifySameDistances<PointType, DistanceFunctor>(queries[i], neighbours, kdtree.knnSearch(queries[i], k));
+    EXPECT_TRUE(std::is_sorted(neighbours.begin(), neighbours.end(), [&](const auto& a, const auto& b) {
+      return distance(a, queries[i]) < distance(b, queries[i]);
+    }));
+  }
+}
+
+/**
+ * @brief A radius search that covers all points lists them in the order of the tree, so equal outputs
+ * mean equal trees.
+ */
+template <size_t Dims>
+void parallelBuildTest(size_t point_count, size_t num_threads) {
+  using PointType = std::array<int, Dims>;
+
+  auto points = rq_utils::generatePoints<Dims>(point_count);
+  kdtree::KDTree<PointType, Dims> sequential(points);
+  kdtree::KDTree<PointType, Dims> parallel(points, num_threads);
+
+  PointType origin{};
+  EXPECT_EQ(sequential.radiusSearch(origin, 100000), parallel.radiusSearch(origin, 100000));
+}
+
 TEST(KDTreeTest, nnSearchSmall2D) {
   nnSearchTest(std::vector<std::array<int, 2>>{{0, 0}, {1, 0}, {0, 1}, {1, 1}, {-1, 0}, {0, -1}, {-1, -1}});
 }
@@ -165,4 +155,21 @@ TEST(KDTreeTest, radiusSearchLarge5D) {
   radiusSearchTest<5>(1000);
 }
 
-}  // namespace test::kdtree::unit
\ No newline at end of file
+TEST(KDTreeTest, knnSearchBatch) {
+  knnSearchBatchTest<2>(1, 1, 1);
+  knnSearchBatchTest<2>(1000, 0, 2);
+  knnSearchBatchTest<2>(1000, 8, 1);
+  knnSearchBatchTest<3>(1000, 1, 4);
+  knnSearchBatchTest<5>(1000, 32, 3);
+  knnSearchBatchTest<3>(1000, 1000, 4);
+}
+
+TEST(KDTreeTest, ParallelBuild) {
+  parallelBuildTest<2>(1, 4);
+  parallelBuildTest<2>(100000, 1);
+  parallelBuildTest<2>(100000, 3);
+  parallelBuildTest<3>(200000, 8);
+  parallelBuildTest<5>(100000, 5);
+}
+
+}  // namespace test::kdtree::unit
@@ -0,0 +1,79 @@
+#include "algo/segment_tree/beats.h"
+#include "algo/segment_tree/dynamic_segment_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+
+#include <gtest/gtest.h>
+
+namespace test::sgt::unit {
+
+namespace sgt = ::algo::sgt;
+
+using Node = sgt::BeatsNode<int64_t>;
+using Op = sgt::BeatsOp<int64_t>;
+using Update = sgt::BeatsUpdate<int64_t>;
+
+/**
+ * @brief Extracts the maximum (the minimum if Min) of the segment from the node.
+ */
+template <bool Min>
+struct Extremum {
+  Extremum(int64_t x) : value(x) {}
+  Extremum(const Node& node) : value(Min ? node.min1 : node.max1) {}
+
+  bool operator==(const Extremum&) const = default;
+
+  int64_t value;
+};
+
+Update generateUpdate() {
+  auto kind = Update::Kind(utility::random::uniform(0, 2));
+  return {kind, utility::random::uniform<int64_t>(-10, 10)};
+}
+
+template <typename Tree>
+void TestBeatsvsNaiveSum(size_t size) {
+  rq_utils::compareRangeEnginesMutableRange<
+      Tree, rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, 1>, int64_t, int64_t>(
+      {size}, 2 * size, generateUpdate);
+}
+
+void TestBeatsvsNaiveMax(size_t size) {
+  rq_utils::compareRangeEnginesMutableRange<
+      sgt::BeatsSegmentTree<int64_t>, rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::MaxOp<int64_t>, 1>, int64_t,
+      Extremum<false>>({size}, 2 * size, generateUpdate);
+}
+
+void TestBeatsvsNaiveMin(size_t size) {
+  rq_utils::compareRangeEnginesMutableRange<
+      sgt::BeatsSegmentTree<int64_t>, rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::MinOp<int64_t>, 1>, int64_t,
+      Extremum<true>>({size}, 2 * size, generateUpdate);
+}
+
+TEST(BeatsSegmentTreeTest, SumCorrectness) {
+  TestBeatsvsNaiveSum<sgt::BeatsSegmentTree<int64_t>>(1);
+  TestBeatsvsNaiveSum<sgt::BeatsSegmentTree<int64_t>>(13);
+  TestBeatsvsNaiveSum<sgt::BeatsSegmentTree<int64_t>>(10000);
+}
+
+TEST(BeatsSegmentTreeTest, MaxCorrectness) {
+  TestBeatsvsNaiveMax(1);
+  TestBeatsvsNaiveMax(13);
+  TestBeatsvsNaiveMax(10000);
+}
+
+TEST(BeatsSegmentTreeTest, MinCorrectness) {
+  TestBeatsvsNaiveMin(1);
+  TestBeatsvsNaiveMin(13);
+  TestBeatsvsNaiveMin(10000);
+}
+
+TEST(BeatsSegmentTreeTest, DynamicSumCorrectness) {
+  TestBeatsvsNaiveSum<sgt::DynamicSegmentTree<Node, Op>>(1);
+  TestBeatsvsNaiveSum<sgt::DynamicSegmentTree<Node, Op>>(13);
+  TestBeatsvsNaiveSum<sgt::DynamicSegmentTree<Node, Op>>(10000);
+}
+
+}  // namespace test::sgt::unit
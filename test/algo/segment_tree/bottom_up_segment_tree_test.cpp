@@ -0,0 +1,51 @@
+#include "algo/segment_tree/bottom_up_segment_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
+
+#include <gtest/gtest.h>
+
+namespace test::sgt::unit {
+
+namespace sgt = ::algo::sgt;
+
+void TestBottomUpSGTvsNaiveMin(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::SimpleBottomUpSegmentTree<int, rq_utils::MinOp<int>>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, 1>>({size}, 2 * size);
+}
+
+void TestBottomUpSGTvsNaiveMinAndCount(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::BottomUpSegmentTree<MinAndCountNode, MinAndCountOp>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinAndCountOp<int>, 1>, int, std::pair<int, int> >(
+      {size}, 2 * size);
+}
+
+void TestBottomUpSGTvsSGT(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::SimpleBottomUpSegmentTree<int, rq_utils::SumOp<int>>,
+      sgt::SimpleSegmentTree<int, rq_utils::SumOp<int>, 1>>({size}, 2 * size);
+}
+
+TEST(BottomUpSegmentTreeTest, MinCorrectness) {
+  TestBottomUpSGTvsNaiveMin(1);
+  TestBottomUpSGTvsNaiveMin(13);
+  TestBottomUpSGTvsNaiveMin(10000);
+}
+
+TEST(BottomUpSegmentTreeTest, MinAndCountCorrectness) {
+  TestBottomUpSGTvsNaiveMinAndCount(1);
+  TestBottomUpSGTvsNaiveMinAndCount(13);
+  TestBottomUpSGTvsNaiveMinAndCount(10000);
+}
+
+TEST(BottomUpSegmentTreeTest, SameAsSegmentTree) {
+  TestBottomUpSGTvsSGT(1);
+  TestBottomUpSGTvsSGT(1024);
+  TestBottomUpSGTvsSGT(100000);
+}
+
+}  // namespace test::sgt::unit
@@ -0,0 +1,149 @@
+#include "algo/segment_tree/concurrent_segment_tree.h"
+#include "algo/segment_tree/segment_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace test::sgt::unit {
+
+namespace sgt = ::algo::sgt;
+
+/**
+ * @brief Publishes every update right away, so that it can be compared against other engines.
+ */
+template <typename Tree>
+struct PublishingSegmentTree : sgt::ConcurrentSegmentTree<Tree> {
+  using Base = sgt::ConcurrentSegmentTree<Tree>;
+  using Base::Base;
+
+  template <typename... Args>
+  void update(Args&&... args) {
+    Base::update(std::forward<Args>(args)...);
+    Base::publish();
+  }
+
+  template <typename... Args>
+  void updateRange(Args&&... args) {
+    Base::updateRange(std::forward<Args>(args)...);
+    Base::publish();
+  }
+};
+
+void TestConcurrentSGTvsNaiveMin(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      PublishingSegmentTree<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>>>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, 1>>({size}, 2 * size);
+}
+
+void TestConcurrentSGTvsNaiveSumRangeUpdate(size_t size) {
+  rq_utils::compareRangeEnginesMutableRange<
+      PublishingSegmentTree<sgt::SegmentTree<SumAddNode, SumAddOp>>,
+      rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, 1>, int64_t, int64_t>({size}, 2 * size);
+}
+
+TEST(ConcurrentSegmentTreeTest, MinCorrectness) {
+  TestConcurrentSGTvsNaiveMin(1);
+  TestConcurrentSGTvsNaiveMin(13);
+  TestConcurrentSGTvsNaiveMin(1000);
+}
+
+TEST(ConcurrentSegmentTreeTest, SumRangeUpdateCorrectness) {
+  TestConcurrentSGTvsNaiveSumRangeUpdate(1);
+  TestConcurrentSGTvsNaiveSumRangeUpdate(13);
+  TestConcurrentSGTvsNaiveSumRangeUpdate(1000);
+}
+
+TEST(ConcurrentSegmentTreeTest, UpdatesVisibleAfterPublish) {
+  sgt::ConcurrentSegmentTree<sgt::SimpleSegmentTree<int, rq_utils::SumOp<int>>> tree{algo::types::Index<1>{{10}}};
+  auto query_handle = tree.getQueryHandle();
+  auto range_query_handle = tree.getRangeQueryHandle();
+  range_query_handle.getRange().left[0] = 0;
+  range_query_handle.getRange().right[0] = 9;
+
+  auto old_snapshot = tree.snapshot();
+  for (size_t i = 0; i < 10; ++i) {
+    query_handle.getIndex()[0] = i;
+    tree.update(query_handle, 1);
+  }
+  ASSERT_EQ(int(tree.query(range_query_handle)), 0);
+
+  tree.publish();
+  ASSERT_EQ(int(tree.query(range_query_handle)), 10);
+  ASSERT_EQ(int(old_snapshot->query(range_query_handle)), 0);
+
+  // The writer has to wait for the old snapshot to be released, do it from another thread
+  std::thread writer([&] {
+    tree.update(query_handle, 2);
+    tree.publish();
+  });
+  ASSERT_EQ(int(old_snapshot->query(range_query_handle)), 0);
+  old_snapshot.reset();
+  writer.join();
+  ASSERT_EQ(int(tree.query(range_query_handle)), 11);
+}
+
+/**
+ * @brief The writer adds 1 to every element in two range updates per version, readers must never
+ * observe a half-applied version.
+ */
+TEST(ConcurrentSegmentTreeTest, ReadersSeeConsistentSnapshots) {
+  constexpr size_t kSize = 1000;
+  constexpr int64_t kVersions = 200;
+  constexpr size_t kReaders = 4;
+
+  std::vector<int64_t> zeros(kSize, 0);
+  sgt::ConcurrentSegmentTree<sgt::SegmentTree<SumAddNode, SumAddOp>> tree{algo::utility::asView(zeros)};
+  std::atomic<bool> done = false;
+
+  std::vector<std::thread> readers;
+  std::vector<int64_t> observed(kReaders, 0);
+  for (size_t reader = 0; reader < kReaders; ++reader) {
+    readers.emplace_back([&, reader] {
+      auto handle = tree.getRangeQueryHandle();
+      handle.getRange().left[0] = 0;
+      handle.getRange().right[0] = kSize - 1;
+
+      int64_t last = 0;
+      while (!done.load()) {
+        int64_t sum = tree.query(handle);
+        if (sum % int64_t(kSize) != 0 || sum < last) {
+          observed[reader] = -1;
+          return;
+        }
+        last = sum;
+      }
+      observed[reader] = last;
+    });
+  }
+
+  auto handle = tree.getRangeQueryHandle();
+  for (int64_t version = 0; version < kVersions; ++version) {
+    handle.getRange().left[0] = 0;
+    handle.getRange().right[0] = kSize / 3;
+    tree.updateRange(handle, 1);
+    handle.getRange().left[0] = kSize / 3 + 1;
+    handle.getRange().right[0] = kSize - 1;
+    tree.updateRange(handle, 1);
+    tree.publish();
+  }
+  done.store(true);
+
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  for (int64_t last : observed) {
+    ASSERT_GE(last, 0);
+  }
+
+  handle.getRange().left[0] = 0;
+  ASSERT_EQ(int64_t(tree.query(handle)), kVersions * int64_t(kSize));
+}
+
+}  // namespace test::sgt::unit
@@ -0,0 +1,121 @@
+#include "algo/segment_tree/dynamic_segment_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
+
+#include <gtest/gtest.h>
+#include <bit>
+#include <map>
+#include <tuple>
+
+namespace test::sgt::unit {
+
+namespace sgt = ::algo::sgt;
+
+void TestDynamicSGTvsNaiveMin(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::SimpleDynamicSegmentTree<int, rq_utils::MinOp<int>>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, 1>>({size}, 2 * size);
+}
+
+void TestDynamicSGTvsNaiveMinAndCount(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::DynamicSegmentTree<MinAndCountNode, MinAndCountOp>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinAndCountOp<int>, 1>, int, std::pair<int, int> >(
+      {size}, 2 * size);
+}
+
+void TestDynamicSGTvsNaiveSumRangeUpdate(size_t size) {
+  rq_utils::compareRangeEnginesMutableRange<
+      sgt::DynamicSegmentTree<SumAddNode, SumAddOp>,
+      rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, 1>, int64_t, int64_t>({size}, 2 * size);
+}
+
+/**
+ * @brief Point assignments at random coordinates of a huge tree, checked against a map of assigned values.
+ */
+void TestDynamicSGTSparseSum(size_t size, size_t samples) {
+  algo::types::Index<1> dims{{size}};
+  std::map<size_t, int64_t> values;
+  sgt::SimpleDynamicSegmentTree<int64_t, rq_utils::SumOp<int64_t>> tree{dims};
+
+  auto query_handle = tree.getQueryHandle();
+  auto range_query_handle = tree.getRangeQueryHandle();
+
+  for (size_t sample = 0; sample < samples; ++sample) {
+    rq_utils::randomIndex(query_handle.getIndex(), dims);
+    int64_t value = utility::random::uniform<int64_t>(-100, 100);
+    tree.update(query_handle, value);
+    values[query_handle.getIndex()[0]] = value;
+
+    auto& [ql, qr] = range_query_handle.getRange();
+    rq_utils::randomRange(ql, qr, dims);
+
+    int64_t expected = 0;
+    for (auto it = values.lower_bound(ql[0]); it != values.end() && it->first <= qr[0]; ++it) {
+      expected += it->second;
+    }
+    ASSERT_EQ(int64_t(tree.query(range_query_handle)), expected);
+  }
+
+  ASSERT_LE(tree.nodes(), 1 + samples * std::bit_width(size));
+}
+
+/**
+ * @brief Range additions over a huge tree, checked against the list of applied additions.
+ */
+void TestDynamicSGTSparseSumRangeUpdate(size_t size, size_t samples) {
+  algo::types::Index<1> dims{{size}};
+  std::vector<std::tuple<size_t, size_t, int64_t>> additions;
+  sgt::DynamicSegmentTree<SumAddNode, SumAddOp> tree{dims};
+
+  auto range_query_handle = tree.getRangeQueryHandle();
+  auto& [ql, qr] = range_query_handle.getRange();
+
+  while (samples--) {
+    rq_utils::randomRange(ql, qr, dims);
+    int64_t value = utility::random::uniform<int64_t>(-10, 10);
+    tree.updateRange(range_query_handle, value);
+    additions.emplace_back(ql[0], qr[0], value);
+
+    rq_utils::randomRange(ql, qr, dims);
+    int64_t expected = 0;
+    for (auto [l, r, x] : additions) {
+      size_t from = std::max(l, ql[0]);
+      size_t to = std::min(r, qr[0]);
+      expected += from <= to ? int64_t(to - from + 1) * x : 0;
+    }
+    ASSERT_EQ(int64_t(tree.query(range_query_handle)), expected);
+  }
+}
+
+TEST(DynamicSegmentTreeTest, MinCorrectness) {
+  TestDynamicSGTvsNaiveMin(1);
+  TestDynamicSGTvsNaiveMin(13);
+  TestDynamicSGTvsNaiveMin(10000);
+}
+
+TEST(DynamicSegmentTreeTest, MinAndCountCorrectness) {
+  TestDynamicSGTvsNaiveMinAndCount(1);
+  TestDynamicSGTvsNaiveMinAndCount(13);
+  TestDynamicSGTvsNaiveMinAndCount(10000);
+}
+
+TEST(DynamicSegmentTreeTest, SumRangeUpdateCorrectness) {
+  TestDynamicSGTvsNaiveSumRangeUpdate(1);
+  TestDynamicSGTvsNaiveSumRangeUpdate(13);
+  TestDynamicSGTvsNaiveSumRangeUpdate(10000);
+}
+
+TEST(DynamicSegmentTreeTest, SparseSumCorrectness) {
+  TestDynamicSGTSparseSum(1ULL << 40, 1000);
+  TestDynamicSGTSparseSum(std::numeric_limits<size_t>::max(), 1000);
+}
+
+TEST(DynamicSegmentTreeTest, SparseSumRangeUpdateCorrectness) {
+  TestDynamicSGTSparseSumRangeUpdate(1'000'000'000'000ULL, 1000);
+}
+
+}  // namespace test::sgt::unit
@@ -0,0 +1,77 @@
+#include "algo/segment_tree/persistent_segment_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
+
+#include <gtest/gtest.h>
+
+namespace test::sgt::unit {
+
+namespace sgt = ::algo::sgt;
+
+void TestPersistentSGTvsNaiveMin(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::SimplePersistentSegmentTree<int, rq_utils::MinOp<int>>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, 1>>({size}, 2 * size);
+}
+
+void TestPersistentSGTvsNaiveMinAndCount(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::PersistentSegmentTree<MinAndCountNode, MinAndCountOp>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinAndCountOp<int>, 1>, int, std::pair<int, int> >(
+      {size}, 2 * size);
+}
+
+/**
+ * @brief Updates random versions and checks random queries against all versions ever created.
+ */
+void TestPersistentSGTVersions(size_t size, size_t updates) {
+  std::array<size_t, 1> dims = {size};
+  std::vector<std::vector<int>> history = {rq_utils::generate(-100, 100, dims)};
+  sgt::SimplePersistentSegmentTree<int, rq_utils::SumOp<int>> tree{algo::utility::asView(history.front())};
+
+  auto query_handle = tree.getQueryHandle();
+  auto range_query_handle = tree.getRangeQueryHandle();
+
+  while (updates--) {
+    size_t version = utility::random::uniform<size_t>(0, tree.latest());
+    rq_utils::randomIndex(query_handle.getIndex(), dims);
+    int value = utility::random::uniform(-100, 100);
+
+    ASSERT_EQ(tree.update(version, query_handle, value), history.size());
+    history.push_back(history[version]);
+    history.back()[query_handle.getIndex()[0]] = value;
+
+    version = utility::random::uniform<size_t>(0, tree.latest());
+    auto& [ql, qr] = range_query_handle.getRange();
+    rq_utils::randomRange(ql, qr, dims);
+
+    int expected = 0;
+    for (size_t i = ql[0]; i <= qr[0]; ++i) {
+      expected += history[version][i];
+    }
+    ASSERT_EQ(int(tree.query(version, range_query_handle)), expected);
+  }
+}
+
+TEST(PersistentSegmentTreeTest, MinCorrectness) {
+  TestPersistentSGTvsNaiveMin(1);
+  TestPersistentSGTvsNaiveMin(13);
+  TestPersistentSGTvsNaiveMin(10000);
+}
+
+TEST(PersistentSegmentTreeTest, MinAndCountCorrectness) {
+  TestPersistentSGTvsNaiveMinAndCount(1);
+  TestPersistentSGTvsNaiveMinAndCount(13);
+  TestPersistentSGTvsNaiveMinAndCount(10000);
+}
+
+TEST(PersistentSegmentTreeTest, VersionsCorrectness) {
+  TestPersistentSGTVersions(1, 100);
+  TestPersistentSGTVersions(13, 1000);
+  TestPersistentSGTVersions(1000, 5000);
+}
+
+}  // namespace test::sgt::unit
@@ -1,6 +1,16 @@
+#include "algo/segment_tree/beats.h"
+#include "algo/segment_tree/bottom_up_segment_tree.h"
+#include "algo/segment_tree/concurrent_segment_tree.h"
+#include "algo/segment_tree/dynamic_segment_tree.h"
+#include "algo/segment_tree/persistent_segment_tree.h"
 #include "algo/segment_tree/segment_tree.h"
+#include "algo/segment_tree/simd_segment_tree.h"
 #include "test/algo/rq_utils/benchmark.h"
 #include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
+
+#include <mutex>
+#include <optional>
 
 namespace test::sgt::benchmark {
 
@@ -18,9 +28,295 @@ static void BM_segment_tree_update(::benchmark::State& state) {
   rq_utils::rqUpdateBenchmark<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1>>(state);
 }
 
+static void BM_segment_tree_parallel_build(::benchmark::State& state) {
+  rq_utils::rqParallelBuildBenchmark<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1>>(state);
+}
+
+static constexpr size_t kQueryBatchSize = 1024;
+
+template <typename Engine>
+static void segmentTreeQueryBatchBenchmark(::benchmark::State& state, bool batched) {
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate(-100, +100, dims);
+  Engine e{algo::utility::asView(as)};
+  auto query_handle = e.getRangeQueryHandle();
+
+  std::vector<algo::types::Range<1>> ranges(kQueryBatchSize);
+  std::vector<sgt::simple_node<int>> results(kQueryBatchSize, 0);
+  for (auto& range : ranges) {
+    rq_utils::randomRange(range.left, range.right, dims);
+  }
+
+  for (auto _ : state) {
+    if (batched) {
+      e.queryBatch(ranges, results);
+    } else {
+      for (size_t i = 0; i < kQueryBatchSize; ++i) {
+        query_handle.getRange() = ranges[i];
+        results[i] = e.query(query_handle);
+      }
+    }
+    ::benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kQueryBatchSize);
+}
+
+static void BM_segment_tree_query_loop(::benchmark::State& state) {
+  segmentTreeQueryBatchBenchmark<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1>>(state, false);
+}
+
+static void BM_segment_tree_query_batch(::benchmark::State& state) {
+  segmentTreeQueryBatchBenchmark<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1>>(state, true);
+}
+
+template <typename Layout>
+static void BM_segment_tree_layout_query(::benchmark::State& state) {
+  segmentTreeQueryBatchBenchmark<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1, Layout>>(state, false);
+}
+
+template <typename Layout>
+static void BM_segment_tree_layout_update(::benchmark::State& state) {
+  rq_utils::rqUpdateBenchmark<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1, Layout>>(state);
+}
+
+template <bool Descent>
+static void segmentTreeMaxRightBenchmark(::benchmark::State& state) {
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate(0, +100, dims);
+  sgt::SimpleSegmentTree<int, rq_utils::SumOp<int>, 1> tree{algo::utility::asView(as)};
+  auto query_handle = tree.getRangeQueryHandle();
+  auto& [ql, qr] = query_handle.getRange();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    size_t l = utility::random::uniform<size_t>(0, dims[0] - 1);
+    int limit = utility::random::uniform<int>(0, 50 * int(dims[0] - l));
+    auto pred = [limit](int sum) { return sum <= limit; };
+    state.ResumeTiming();
+
+    if constexpr (Descent) {
+      ::benchmark::DoNotOptimize(tree.maxRight(l, pred));
+    } else {
+      // Binary search over the prefix length with a query per step
+      size_t lo = l;
+      size_t hi = dims[0];
+      while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        ql[0] = l;
+        qr[0] = mid - 1;
+        if (pred(tree.query(query_handle))) {
+          lo = mid;
+        } else {
+          hi = mid - 1;
+        }
+      }
+      ::benchmark::DoNotOptimize(lo);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static void BM_segment_tree_max_right(::benchmark::State& state) {
+  segmentTreeMaxRightBenchmark<true>(state);
+}
+
+static void BM_segment_tree_max_right_binary_search(::benchmark::State& state) {
+  segmentTreeMaxRightBenchmark<false>(state);
+}
+
+static void BM_persistent_segment_tree_build(::benchmark::State& state) {
+  rq_utils::rqBuildBenchmark<sgt::SimplePersistentSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_persistent_segment_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<sgt::SimplePersistentSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+/**
+ * @brief Every version stays in the arena until the tree is destroyed, so the tree is rebuilt every
+ * kUpdatesPerTree updates. The updates are generated in advance, so that the timing is not paused on every one.
+ */
+static void BM_persistent_segment_tree_update(::benchmark::State& state) {
+  using Tree = sgt::SimplePersistentSegmentTree<int, rq_utils::MinOp<int>>;
+  static constexpr size_t kUpdates = 1024;
+  static constexpr size_t kUpdatesPerTree = 1ULL << 16;
+
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate(-100, +100, dims);
+  std::optional<Tree> tree;
+  tree.emplace(algo::utility::asView(as));
+
+  std::vector<Tree::QueryHandle> handles(kUpdates, tree->getQueryHandle());
+  std::vector<int> values(kUpdates);
+  for (size_t i = 0; i < kUpdates; ++i) {
+    rq_utils::randomIndex(handles[i].getIndex(), dims);
+    values[i] = utility::random::uniform(-100, 100);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    tree->update(handles[i % kUpdates], values[i % kUpdates]);
+    if (++i % kUpdatesPerTree == 0) {
+      state.PauseTiming();
+      tree.emplace(algo::utility::asView(as));
+      state.ResumeTiming();
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static constexpr size_t kSharedTreeSize = 1ULL << 20;
+
+/**
+ * @brief Tree and query ranges shared by all threads of a benchmark, ranges are generated up front
+ * since the random generator is not thread-safe.
+ */
+template <typename Tree>
+struct SharedTree {
+  static SharedTree& instance() {
+    static SharedTree shared;
+    return shared;
+  }
+
+  std::array<size_t, 1> dims = {kSharedTreeSize};
+  algo::utility::NDVector<int, 1> as = rq_utils::generate(-100, +100, dims);
+  Tree tree{algo::utility::asView(as)};
+  std::vector<algo::types::Range<1>> ranges = [this] {
+    std::vector<algo::types::Range<1>> ranges(kQueryBatchSize);
+    for (auto& range : ranges) {
+      rq_utils::randomRange(range.left, range.right, dims);
+    }
+    return ranges;
+  }();
+  std::mutex mutex;
+};
+
+template <typename Tree, typename Query>
+static void segmentTreeSharedQueryBenchmark(::benchmark::State& state, const Query& query) {
+  auto& shared = SharedTree<Tree>::instance();
+  auto query_handle = shared.tree.getRangeQueryHandle();
+  size_t i = state.thread_index();
+
+  for (auto _ : state) {
+    query_handle.getRange() = shared.ranges[i++ % kQueryBatchSize];
+    ::benchmark::DoNotOptimize(query(shared, query_handle));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_concurrent_segment_tree_query(::benchmark::State& state) {
+  using Tree = sgt::ConcurrentSegmentTree<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1>>;
+  segmentTreeSharedQueryBenchmark<Tree>(state, [](auto& shared, auto& handle) { return shared.tree.query(handle); });
+}
+
+static void BM_mutex_segment_tree_query(::benchmark::State& state) {
+  using Tree = sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, 1>;
+  segmentTreeSharedQueryBenchmark<Tree>(state, [](auto& shared, auto& handle) {
+    std::lock_guard lock(shared.mutex);
+    return shared.tree.query(handle);
+  });
+}
+
+static void BM_dynamic_segment_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<sgt::SimpleDynamicSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_dynamic_segment_tree_update(::benchmark::State& state) {
+  rq_utils::rqUpdateBenchmark<sgt::SimpleDynamicSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_beats_segment_tree_update_range(::benchmark::State& state) {
+  using Update = sgt::BeatsUpdate<int64_t>;
+
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = rq_utils::generate<int64_t, 1>(-1'000'000, 1'000'000, dims);
+  sgt::BeatsSegmentTree<int64_t> tree{algo::utility::asView(as)};
+  auto query_handle = tree.getRangeQueryHandle();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    rq_utils::randomRange(query_handle.getRange().left, query_handle.getRange().right, dims);
+    Update update{Update::Kind(utility::random::uniform(0, 2)), utility::random::uniform<int64_t>(-1000, 1000)};
+    state.ResumeTiming();
+
+    tree.updateRange(query_handle, update);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template <size_t Block>
+static void BM_simd_segment_tree_build(::benchmark::State& state) {
+  rq_utils::rqBuildBenchmark<sgt::SimdSegmentTree<int, rq_utils::MinOp<int>, Block>>(state);
+}
+
+template <size_t Block>
+static void BM_simd_segment_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<sgt::SimdSegmentTree<int, rq_utils::MinOp<int>, Block>>(state);
+}
+
+template <size_t Block>
+static void BM_simd_segment_tree_query_sum(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<sgt::SimdSegmentTree<int, rq_utils::SumOp<int>, Block>>(state);
+}
+
+template <size_t Block>
+static void BM_simd_segment_tree_update(::benchmark::State& state) {
+  rq_utils::rqUpdateBenchmark<sgt::SimdSegmentTree<int, rq_utils::MinOp<int>, Block>>(state);
+}
+
+static void BM_bottom_up_segment_tree_build(::benchmark::State& state) {
+  rq_utils::rqBuildBenchmark<sgt::SimpleBottomUpSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_bottom_up_segment_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<sgt::SimpleBottomUpSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_bottom_up_segment_tree_update(::benchmark::State& state) {
+  rq_utils::rqUpdateBenchmark<sgt::SimpleBottomUpSegmentTree<int, rq_utils::MinOp<int>>>(state);
+}
+
 BENCHMARK(BM_segment_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 BENCHMARK(BM_segment_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 BENCHMARK(BM_segment_tree_update)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_segment_tree_parallel_build)
+    ->ArgsProduct({::benchmark::CreateRange(1ULL << 20, 1ULL << 26, 8), ::benchmark::CreateDenseRange(1, 8, 1)})
+    ->UseRealTime();
+BENCHMARK(BM_segment_tree_query_loop)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 20);
+BENCHMARK(BM_segment_tree_query_batch)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 20);
+
+BENCHMARK(BM_segment_tree_layout_query<sgt::EytzingerLayout>)->RangeMultiplier(4)->Range(1ULL << 20, 1ULL << 26);
+BENCHMARK(BM_segment_tree_layout_query<sgt::BlockedLayout<>>)->RangeMultiplier(4)->Range(1ULL << 20, 1ULL << 26);
+BENCHMARK(BM_segment_tree_layout_query<sgt::VanEmdeBoasLayout>)->RangeMultiplier(4)->Range(1ULL << 20, 1ULL << 26);
+BENCHMARK(BM_segment_tree_layout_update<sgt::EytzingerLayout>)->RangeMultiplier(4)->Range(1ULL << 20, 1ULL << 26);
+BENCHMARK(BM_segment_tree_layout_update<sgt::BlockedLayout<>>)->RangeMultiplier(4)->Range(1ULL << 20, 1ULL << 26);
+BENCHMARK(BM_segment_tree_layout_update<sgt::VanEmdeBoasLayout>)->RangeMultiplier(4)->Range(1ULL << 20, 1ULL << 26);
+
+BENCHMARK(BM_segment_tree_max_right)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 20)->Complexity();
+BENCHMARK(BM_segment_tree_max_right_binary_search)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 20)->Complexity();
+
+BENCHMARK(BM_persistent_segment_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_persistent_segment_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_persistent_segment_tree_update)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+
+BENCHMARK(BM_concurrent_segment_tree_query)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_mutex_segment_tree_query)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_dynamic_segment_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_dynamic_segment_tree_update)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+
+BENCHMARK(BM_beats_segment_tree_update_range)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+
+BENCHMARK(BM_simd_segment_tree_build<16>)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_simd_segment_tree_query<8>)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 24);
+BENCHMARK(BM_simd_segment_tree_query<16>)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 24);
+BENCHMARK(BM_simd_segment_tree_query<64>)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 24);
+BENCHMARK(BM_simd_segment_tree_query_sum<16>)->RangeMultiplier(4)->Range(1ULL << 10, 1ULL << 24);
+BENCHMARK(BM_simd_segment_tree_update<16>)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+
+BENCHMARK(BM_bottom_up_segment_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_bottom_up_segment_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_bottom_up_segment_tree_update)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 
 }  // namespace test::sgt::benchmark
 
@@ -3,6 +3,7 @@
 #include "test/algo/rq_utils/compare_range_engines.h"
 #include "test/algo/rq_utils/generate.h"
 #include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
 
 #include <gtest/gtest.h>
 #include <optional>
@@ -12,129 +13,76 @@ namespace test::sgt::unit {
 
 namespace sgt = ::algo::sgt;
 
-template <size_t NDims>
+template <size_t NDims, typename Layout = sgt::EytzingerLayout>
 void TestSGTvsNaiveMin(const std::array<size_t, NDims>& dims) {
   rq_utils::compareRangeEnginesMutable<
-      sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, NDims>,
+      sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, NDims, Layout>,
       rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, NDims> >(
       dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
 }
 
-template <size_t NDims>
+template <size_t NDims, typename Layout = sgt::EytzingerLayout>
 void TestSGTvsNaiveMinAndCount(const std::array<size_t, NDims>& dims) {
-  /**
-   * @brief For the underlying segment:
-   *  - stores minimal value,
-   *  - stores the count of values equal to minimal value.
-   */
-  struct MinAndCountNode {
-    using value_type = int;
-    MinAndCountNode(value_type x) : min_value(x), min_count(1) {}
-
-    operator std::pair<int, int>() const {
-      return {min_value, min_count};
-    }
-
-    value_type min_value;
-    int min_count;
-  };
-
-  /**
-   * @brief Combines minimal values and their respective counts appropriately
-   */
-  struct MinAndCountOp : public sgt::base_op<MinAndCountNode, MinAndCountOp> {
-    using Node = MinAndCountNode;
-
-    Node neutral() const noexcept {
-      return Node(std::numeric_limits<int>::max());
-    }
-
-    void updateLeaf(Node& node, int value) {
-      node.min_value = value;
-    }
-
-    Node combine(const Node& left, const Node& right) {
-      Node node(std::min(left.min_value, right.min_value));
-      node.min_count = 0;
-      node.min_count += left.min_value == node.min_value ? left.min_count : 0;
-      node.min_count += right.min_value == node.min_value ? right.min_count : 0;
-      return node;
-    }
-  };
-
   rq_utils::compareRangeEnginesMutable<
-      sgt::SegmentTree<MinAndCountNode, MinAndCountOp, NDims>,
+      sgt::SegmentTree<MinAndCountNode, MinAndCountOp, NDims, Layout>,
       rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinAndCountOp<int>, NDims>, int, std::pair<int, int> >(
       dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
 }
 
-template <size_t NDims>
+template <size_t NDims, typename Layout = sgt::EytzingerLayout>
 void TestSGTvsNaiveSumRangeUpdate(const std::array<size_t, NDims>& dims) {
-  /**
-   * @brief For the underlying segment:
-   *  - stores sum of segment's values,
-   *  - optionally stores the value added to all its elements.
-   */
-  struct SumAddNode {
-    using value_type = int64_t;
-    SumAddNode(value_type sum, int64_t size) : sum(sum), size(size) {}
-
-    operator int64_t() const noexcept {
-      return get_sum();
-    }
-    int64_t get_sum() const noexcept {
-      return sum + size * added;
-    }
-    void operator=(int64_t x) noexcept {
-      sum = x;
-    }
-
-    int64_t sum;
-    int64_t size;
-    int64_t added = 0;
-  };
+  // This will not work for NDims > 1 because push strategy with sum works for 1D only
+  rq_utils::compareRangeEnginesMutableRange<
+      sgt::SegmentTree<SumAddNode, SumAddOp, NDims, Layout>,
+      rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, NDims>, int64_t, int64_t>(
+      dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
+}
 
-  /**
-   * @brief Operation for SumAssignNode.
-   */
-  struct SumAddOp : public sgt::base_op<SumAddNode, SumAddOp> {
-    using Node = SumAddNode;
+template <typename Tree, size_t NumThreads>
+struct ParallelBuiltSegmentTree : Tree {
+  explicit ParallelBuiltSegmentTree(auto view) : Tree(view, NumThreads) {}
+};
 
-    Node neutral() const noexcept {
-      return Node(0, 0);
-    }
-    Node init() const noexcept {
-      return Node(0, 1);
-    }
+template <size_t NDims, size_t NumThreads>
+void TestSGTParallelBuildMin(const std::array<size_t, NDims>& dims) {
+  rq_utils::compareRangeEnginesMutable<
+      ParallelBuiltSegmentTree<sgt::SimpleSegmentTree<int, rq_utils::MinOp<int>, NDims>, NumThreads>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, NDims> >(
+      dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
+}
 
-    Node combine(const Node& left, const Node& right) {
-      return Node(left.get_sum() + right.get_sum(), left.size + right.size);
-    }
+template <size_t NumThreads>
+void TestSGTParallelBuildSumRangeUpdate(size_t size) {
+  rq_utils::compareRangeEnginesMutableRange<
+      ParallelBuiltSegmentTree<sgt::SegmentTree<SumAddNode, SumAddOp, 1>, NumThreads>,
+      rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, 1>, int64_t, int64_t>({size}, 2 * size);
+}
 
-    void push(Node& root, Node& left, Node& right) {
-      if (root.added == 0)
-        return;
+template <typename Node, typename Op, typename Output, size_t NDims>
+void TestSGTQueryBatch(const std::array<size_t, NDims>& dims, size_t batch_size, size_t batches) {
+  auto as = rq_utils::generate<typename Node::value_type, NDims>(-10, 10, dims);
+  sgt::SegmentTree<Node, Op, NDims> tree{algo::utility::asView(as)};
+  auto query_handle = tree.getRangeQueryHandle();
 
-      left.added += root.added;
-      right.added += root.added;
+  std::vector<algo::types::Range<NDims>> ranges(batch_size);
+  std::vector<Node> results(batch_size, Op().neutral());
 
-      root.sum = left.get_sum() + right.get_sum();
-      root.added = 0;
+  while (batches--) {
+    for (auto& range : ranges) {
+      rq_utils::randomRange(range.left, range.right, dims);
     }
+    ranges.front().left[0] = dims[0] - 1;
+    ranges.front().right[0] = 0;
 
-    void updateLeaf(Node& node, int64_t value) {
-      node.added += value;
-    }
-    void updateRange(Node& node, int64_t value) {
-      node.added += value;
+    tree.queryBatch(ranges, results);
+    for (size_t i = 0; i < batch_size; ++i) {
+      query_handle.getRange() = ranges[i];
+      ASSERT_EQ(Output(tree.query(query_handle)), Output(results[i]));
     }
-  };
 
-  // This will not work for NDims > 1 because push strategy with sum works for 1D only
-  rq_utils::compareRangeEnginesMutableRange<
-      sgt::SegmentTree<SumAddNode, SumAddOp, NDims>,
-      rq_utils::NaiveRangeQueryEngine<int64_t, rq_utils::SumOp<int64_t>, NDims>, int64_t, int64_t>(
-      dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
+    rq_utils::randomRange(query_handle.getRange().left, query_handle.getRange().right, dims);
+    tree.updateRange(query_handle, utility::random::uniform(-10, 10));
+  }
 }
 
 TEST(SegmentTreeTest, MinDims1Correctness) {
@@ -167,4 +115,111 @@ TEST(SegmentTreeTest, SumRangeUpdateDims1Correctness) {
   TestSGTvsNaiveSumRangeUpdate<1>({10000});
 }
 
+TEST(SegmentTreeTest, ParallelBuildCorrectness) {
+  TestSGTParallelBuildMin<1, 1>({1});
+  TestSGTParallelBuildMin<1, 4>({1});
+  TestSGTParallelBuildMin<1, 3>({10000});
+  TestSGTParallelBuildMin<1, 8>({10000});
+  TestSGTParallelBuildMin<2, 4>({73, 237});
+  TestSGTParallelBuildMin<3, 5>({13, 27, 49});
+  TestSGTParallelBuildSumRangeUpdate<4>(10000);
+}
+
+/**
+ * @brief Checks maxRight and minLeft against a linear scan with single queries, range updates in between.
+ */
+template <typename Node, typename Op, typename Layout = sgt::EytzingerLayout, typename Pred>
+void TestSGTMaxRightMinLeft(size_t size, size_t samples, const Pred& pred) {
+  std::array<size_t, 1> dims = {size};
+  auto as = rq_utils::generate<typename Node::value_type, 1>(0, 10, dims);
+  sgt::SegmentTree<Node, Op, 1, Layout> tree{algo::utility::asView(as)};
+  auto query_handle = tree.getRangeQueryHandle();
+  auto& [ql, qr] = query_handle.getRange();
+
+  auto holds = [&](size_t l, size_t r) {
+    if (l == r) {
+      return true;
+    }
+    ql[0] = l;
+    qr[0] = r - 1;
+    return pred(tree.query(query_handle));
+  };
+
+  while (samples--) {
+    size_t l = utility::random::uniform<size_t>(0, size);
+    size_t expected = l;
+    while (expected < size && holds(l, expected + 1)) {
+      ++expected;
+    }
+    ASSERT_EQ(tree.maxRight(l, pred), expected);
+
+    size_t r = utility::random::uniform<size_t>(0, size);
+    expected = r;
+    while (expected > 0 && holds(expected - 1, r)) {
+      --expected;
+    }
+    ASSERT_EQ(tree.minLeft(r, pred), expected);
+
+    rq_utils::randomRange(ql, qr, dims);
+    tree.updateRange(query_handle, utility::random::uniform(0, 3));
+  }
+}
+
+TEST(SegmentTreeTest, MaxRightMinLeftSum) {
+  for (int64_t limit : {0, 10, 100, 1000}) {
+    auto pred = [limit](const SumAddNode& node) { return node.get_sum() <= limit; };
+    TestSGTMaxRightMinLeft<SumAddNode, SumAddOp>(1, 10, pred);
+    TestSGTMaxRightMinLeft<SumAddNode, SumAddOp>(1000, 200, pred);
+    TestSGTMaxRightMinLeft<SumAddNode, SumAddOp, sgt::VanEmdeBoasLayout>(1000, 200, pred);
+  }
+}
+
+TEST(SegmentTreeTest, MaxRightMinLeftMinAndCount) {
+  for (int bound : {0, 3, 7, 11}) {
+    auto pred = [bound](const MinAndCountNode& node) { return node.min_value >= bound; };
+    TestSGTMaxRightMinLeft<MinAndCountNode, MinAndCountOp>(1, 10, pred);
+    TestSGTMaxRightMinLeft<MinAndCountNode, MinAndCountOp>(1000, 200, pred);
+  }
+}
+
+template <size_t NDims>
+void TestSGTQueryBatchMin(const std::array<size_t, NDims>& dims) {
+  using Node = sgt::simple_node<int>;
+  TestSGTQueryBatch<Node, sgt::simple_op<Node, rq_utils::MinOp<int>>, int>(dims, 1000, 10);
+}
+
+TEST(SegmentTreeTest, QueryBatchMinDims1) {
+  TestSGTQueryBatchMin<1>({10000});
+}
+TEST(SegmentTreeTest, QueryBatchMinDims2) {
+  TestSGTQueryBatchMin<2>({73, 237});
+}
+TEST(SegmentTreeTest, QueryBatchMinDims3) {
+  TestSGTQueryBatchMin<3>({13, 27, 49});
+}
+TEST(SegmentTreeTest, QueryBatchMinAndCountDims2) {
+  TestSGTQueryBatch<MinAndCountNode, MinAndCountOp, std::pair<int, int>>(std::array<size_t, 2>{73, 237}, 1000, 10);
+}
+TEST(SegmentTreeTest, QueryBatchSumRangeUpdateDims1) {
+  TestSGTQueryBatch<SumAddNode, SumAddOp, int64_t>(std::array<size_t, 1>{10000}, 1000, 100);
+}
+
+template <typename Layout>
+void TestSGTLayout() {
+  TestSGTvsNaiveMin<1, Layout>({1});
+  TestSGTvsNaiveMin<1, Layout>({10000});
+  TestSGTvsNaiveMin<2, Layout>({73, 237});
+  TestSGTvsNaiveMin<3, Layout>({13, 27, 49});
+  TestSGTvsNaiveMinAndCount<2, Layout>({73, 237});
+  TestSGTvsNaiveSumRangeUpdate<1, Layout>({10000});
+}
+
+TEST(SegmentTreeTest, BlockedLayoutCorrectness) {
+  TestSGTLayout<sgt::BlockedLayout<>>();
+  TestSGTLayout<sgt::BlockedLayout<3>>();
+}
+TEST(SegmentTreeTest, VanEmdeBoasLayoutCorrectness) {
+  TestSGTLayout<sgt::VanEmdeBoasLayout>();
+}
+
 }  // namespace test::sgt::unit
@@ -0,0 +1,48 @@
+#include "algo/segment_tree/simd_segment_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+#include "test/algo/segment_tree/ops.h"
+
+#include <gtest/gtest.h>
+
+namespace test::sgt::unit {
+
+namespace sgt = ::algo::sgt;
+
+template <typename T, template <typename> typename Op, size_t Block>
+void TestSimdSGTvsNaive(size_t size) {
+  rq_utils::compareRangeEnginesMutable<
+      sgt::SimdSegmentTree<T, Op<T>, Block>, rq_utils::NaiveRangeQueryEngine<T, Op<T>, 1>, T, T>({size}, 2 * size);
+}
+
+template <template <typename> typename Op>
+void TestSimdSGTvsNaiveAllBlocks() {
+  for (size_t size : {1, 7, 8, 13, 16, 17, 1000}) {
+    TestSimdSGTvsNaive<int, Op, 8>(size);
+    TestSimdSGTvsNaive<int, Op, 16>(size);
+    TestSimdSGTvsNaive<int, Op, 64>(size);
+  }
+}
+
+TEST(SimdSegmentTreeTest, MinCorrectness) {
+  TestSimdSGTvsNaiveAllBlocks<rq_utils::MinOp>();
+}
+
+TEST(SimdSegmentTreeTest, MaxCorrectness) {
+  TestSimdSGTvsNaiveAllBlocks<rq_utils::MaxOp>();
+}
+
+TEST(SimdSegmentTreeTest, SumCorrectness) {
+  TestSimdSGTvsNaiveAllBlocks<rq_utils::SumOp>();
+}
+
+TEST(SimdSegmentTreeTest, ScalarFallbackCorrectness) {
+  // No vectorized kernel for int64_t, reduced with the scalar loop
+  TestSimdSGTvsNaive<int64_t, rq_utils::SumOp, 16>(1);
+  TestSimdSGTvsNaive<int64_t, rq_utils::SumOp, 16>(13);
+  TestSimdSGTvsNaive<int64_t, rq_utils::SumOp, 16>(1000);
+}
+
+}  // namespace test::sgt::unit
@@ -0,0 +1,31 @@
+#include "algo/sparse_tree/block_sparse_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+
+#include <gtest/gtest.h>
+
+namespace test::spt::unit {
+
+namespace spt = ::algo::spt;
+
+template <template <typename> typename Op>
+void TestBSPTvsNaive(size_t size) {
+  rq_utils::compareRangeEnginesImmutable<
+      spt::BlockSparseTree<int, Op<int>>, rq_utils::NaiveRangeQueryEngine<int, Op<int>, 1>>({size}, 2 * size);
+}
+
+TEST(BlockSparseTreeTest, Min) {
+  for (size_t size : {1, 2, 3, 63, 64, 65, 128, 200, 10000}) {
+    TestBSPTvsNaive<rq_utils::MinOp>(size);
+  }
+}
+
+TEST(BlockSparseTreeTest, Max) {
+  for (size_t size : {1, 2, 3, 63, 64, 65, 128, 200, 10000}) {
+    TestBSPTvsNaive<rq_utils::MaxOp>(size);
+  }
+}
+
+}  // namespace test::spt::unit
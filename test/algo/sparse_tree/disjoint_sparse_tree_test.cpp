@@ -0,0 +1,50 @@
+#include "algo/sparse_tree/disjoint_sparse_tree.h"
+
+#include "test/algo/rq_utils/compare_range_engines.h"
+#include "test/algo/rq_utils/generate.h"
+#include "test/algo/rq_utils/range_query.h"
+
+#include <gtest/gtest.h>
+
+namespace test::spt::unit {
+
+namespace spt = ::algo::spt;
+
+/**
+ * @brief Associative, but neither commutative nor idempotent: the first non-zero value of the segment.
+ */
+template <typename T>
+struct FirstNonZeroOp {
+  T operator()(const T& a, const T& b) const noexcept {
+    return a != 0 ? a : b;
+  }
+  T neutral() const noexcept {
+    return T(0);
+  }
+};
+
+template <template <typename> typename Op>
+void TestDSPTvsNaive(size_t size) {
+  rq_utils::compareRangeEnginesImmutable<
+      spt::DisjointSparseTree<int, Op<int>>, rq_utils::NaiveRangeQueryEngine<int, Op<int>, 1>>({size}, 2 * size);
+}
+
+TEST(DisjointSparseTreeTest, Sum) {
+  for (size_t size : {1, 2, 3, 13, 64, 10000}) {
+    TestDSPTvsNaive<rq_utils::SumOp>(size);
+  }
+}
+
+TEST(DisjointSparseTreeTest, Min) {
+  for (size_t size : {1, 2, 3, 13, 64, 10000}) {
+    TestDSPTvsNaive<rq_utils::MinOp>(size);
+  }
+}
+
+TEST(DisjointSparseTreeTest, NonCommutative) {
+  for (size_t size : {1, 2, 3, 13, 64, 10000}) {
+    TestDSPTvsNaive<FirstNonZeroOp>(size);
+  }
+}
+
+}  // namespace test::spt::unit
@@ -1,3 +1,5 @@
+#include "algo/sparse_tree/block_sparse_tree.h"
+#include "algo/sparse_tree/disjoint_sparse_tree.h"
 #include "algo/sparse_tree/sparse_tree.h"
 #include "test/algo/rq_utils/benchmark.h"
 #include "test/algo/rq_utils/range_query.h"
@@ -14,8 +16,69 @@ static void BM_sparse_tree_query(::benchmark::State& state) {
   rq_utils::rqQueryBenchmark<spt::SparseTree<int, rq_utils::MinOp<int>, 1>>(state);
 }
 
+static void BM_sparse_tree_parallel_build(::benchmark::State& state) {
+  rq_utils::rqParallelBuildBenchmark<spt::SparseTree<int, rq_utils::MinOp<int>, 1>>(state);
+}
+
+/**
+ * @brief Builds a range(0) x range(0) tree with range(1) threads.
+ */
+static void BM_sparse_tree_parallel_build_2d(::benchmark::State& state) {
+  std::array<size_t, 2> dims;
+  dims.fill(size_t(state.range(0)));
+  auto as = rq_utils::generate(-100, +100, dims);
+
+  for (auto _ : state) {
+    spt::SparseTree<int, rq_utils::MinOp<int>, 2> tree{algo::utility::asView(as), size_t(state.range(1))};
+    ::benchmark::DoNotOptimize(tree);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+template <size_t NDims>
+static void BM_sparse_tree_query_nd(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmarkNd<spt::SparseTree<int, rq_utils::MinOp<int>, NDims>, NDims>(state);
+}
+
+static void BM_block_sparse_tree_build(::benchmark::State& state) {
+  rq_utils::rqBuildBenchmark<spt::BlockSparseTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_block_sparse_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<spt::BlockSparseTree<int, rq_utils::MinOp<int>>>(state);
+}
+
+static void BM_disjoint_sparse_tree_build(::benchmark::State& state) {
+  rq_utils::rqBuildBenchmark<spt::DisjointSparseTree<int, rq_utils::SumOp<int>>>(state);
+}
+
+static void BM_disjoint_sparse_tree_query(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<spt::DisjointSparseTree<int, rq_utils::SumOp<int>>>(state);
+}
+
+static void BM_disjoint_sparse_tree_query_min(::benchmark::State& state) {
+  rq_utils::rqQueryBenchmark<spt::DisjointSparseTree<int, rq_utils::MinOp<int>>>(state);
+}
+
 BENCHMARK(BM_sparse_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 BENCHMARK(BM_sparse_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_sparse_tree_parallel_build)
+    ->ArgsProduct({::benchmark::CreateRange(1ULL << 20, 1ULL << 24, 16), ::benchmark::CreateDenseRange(1, 8, 1)})
+    ->UseRealTime();
+BENCHMARK(BM_sparse_tree_parallel_build_2d)
+    ->ArgsProduct({::benchmark::CreateRange(1ULL << 10, 1ULL << 11, 2), ::benchmark::CreateDenseRange(1, 8, 1)})
+    ->UseRealTime();
+
+BENCHMARK(BM_sparse_tree_query_nd<1>)->RangeMultiplier(16)->Range(1ULL << 8, 1ULL << 20);
+BENCHMARK(BM_sparse_tree_query_nd<2>)->RangeMultiplier(4)->Range(1ULL << 4, 1ULL << 10);
+BENCHMARK(BM_sparse_tree_query_nd<3>)->RangeMultiplier(2)->Range(1ULL << 3, 1ULL << 6);
+
+BENCHMARK(BM_block_sparse_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_block_sparse_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+
+BENCHMARK(BM_disjoint_sparse_tree_build)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_disjoint_sparse_tree_query)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
+BENCHMARK(BM_disjoint_sparse_tree_query_min)->RangeMultiplier(2)->Range(1, 1ULL << 20)->Complexity();
 
 }  // namespace test::spt::benchmark
 
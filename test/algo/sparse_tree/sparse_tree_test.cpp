@@ -19,6 +19,19 @@ void TestSPTvsNaive(const std::array<size_t, NDims>& dims) {
       dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
 }
 
+template <typename Tree, size_t NumThreads>
+struct ParallelBuiltSparseTree : Tree {
+  explicit ParallelBuiltSparseTree(auto view) : Tree(view, NumThreads) {}
+};
+
+template <size_t NDims, size_t NumThreads>
+void TestSPTParallelBuild(const std::array<size_t, NDims>& dims) {
+  rq_utils::compareRangeEnginesImmutable<
+      ParallelBuiltSparseTree<spt::SparseTree<int, rq_utils::MinOp<int>, NDims>, NumThreads>,
+      rq_utils::NaiveRangeQueryEngine<int, rq_utils::MinOp<int>, NDims>>(
+      dims, 2 * std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<size_t>()));
+}
+
 TEST(SparseTreeTest, Dims1) {
   TestSPTvsNaive<1>({10000});
 }
@@ -32,4 +45,11 @@ TEST(SparseTreeTest, Dims4) {
   TestSPTvsNaive<4>({9, 13, 21, 17});
 }
 
+TEST(SparseTreeTest, ParallelBuild) {
+  TestSPTParallelBuild<1, 4>({1});
+  TestSPTParallelBuild<1, 3>({40000});
+  TestSPTParallelBuild<2, 4>({273, 237});
+  TestSPTParallelBuild<3, 5>({13, 57, 49});
+}
+
 }  // namespace test::spt::unit
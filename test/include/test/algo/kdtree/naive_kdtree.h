@@ -0,0 +1,73 @@
+#pragma once
+
+#include "algo/kdtree/kdtree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace test::kdtree {
+
+namespace kdtree = ::algo::kdtree;
+
+/**
+ * @brief Answers the queries of KDTree by a linear scan over all points.
+ */
+template <typename PointType, size_t Dims, typename DistanceBinaryFunctor = kdtree::EuclideanDistance<PointType>>
+class NaiveKDTree {
+ public:
+  explicit NaiveKDTree(std::vector<PointType> points) noexcept : points_{std::move(points)} {}
+
+  const PointType& nnSearch(const PointType& q) {
+    return *std::min_element(points_.begin(), points_.end(), [&q, this](const auto& a, const auto& b) {
+      return distance_(a, q) < distance_(b, q);
+    });
+  }
+
+  std::vector<PointType> knnSearch(const PointType& q, size_t max_count) {
+    std::sort(points_.begin(), points_.end(), [&q, this](const auto& a, const auto& b) {
+      return distance_(a, q) < distance_(b, q);
+    });
+    return {points_.begin(), points_.begin() + std::min(max_count, points_.size())};
+  }
+
+  std::vector<PointType> radiusSearch(const PointType& q, uint64_t radius) {
+    radius *= radius;
+    std::vector<PointType> output;
+    std::copy_if(points_.begin(), points_.end(), std::back_inserter(output), [&q, radius, this](const PointType& p) {
+      return distance_(q, p) < radius;
+    });
+    return output;
+  }
+
+ private:
+  [[no_unique_address]] DistanceBinaryFunctor distance_;
+  std::vector<PointType> points_;
+};
+
+template <typename PointType, typename DistanceBinaryFunctor>
+void verifySameDistances(const PointType& to, const PointType& a, const PointType& b) {
+  DistanceBinaryFunctor distance;
+  EXPECT_EQ(distance(to, a), distance(to, b));
+}
+
+template <typename PointType, typename DistanceBinaryFunctor>
+void verifySameDistances(const PointType& to, const std::vector<PointType>& p1, const std::vector<PointType>& p2) {
+  std::vector<uint64_t> p1d;
+  std::vector<uint64_t> p2d;
+  p1d.reserve(p1.size());
+  p2d.reserve(p2.size());
+
+  DistanceBinaryFunctor distance;
+  std::transform(p1.begin(), p1.end(), std::back_inserter(p1d), [&](const auto& a) { return distance(a, to); });
+  std::transform(p2.begin(), p2.end(), std::back_inserter(p2d), [&](const auto& a) { return distance(a, to); });
+
+  std::sort(p1d.begin(), p1d.end());
+  std::sort(p2d.begin(), p2d.end());
+  EXPECT_EQ(p1d, p2d);
+}
+
+}  // namespace test::kdtree
@@ -2,6 +2,7 @@
 #include "generate.h"
 
 #include <benchmark/benchmark.h>
+#include <vector>
 
 namespace test::rq_utils {
 
@@ -15,6 +16,19 @@ void rqBuildBenchmark(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+/**
+ * @brief Measures construction of Engine{view, num_threads}: range(0) is the size, range(1) is the number of threads.
+ */
+template <typename Engine>
+void rqParallelBuildBenchmark(benchmark::State& state) {
+  std::array<size_t, 1> dims = {size_t(state.range(0))};
+  auto as = generate(-100, +100, dims);
+  for (auto _ : state) {
+    Engine e{algo::utility::asView(as), size_t(state.range(1))};
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 template <typename Engine>
 void rqQueryBenchmark(benchmark::State& state) {
   std::array<size_t, 1> dims = {size_t(state.range(0))};
@@ -32,6 +46,31 @@ void rqQueryBenchmark(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+/**
+ * @brief Measures range queries on an NDims-dimensional engine with all dimensions equal to range(0).
+ * The ranges are generated in advance, so that the timing is not paused on every query.
+ */
+template <typename Engine, size_t NDims>
+void rqQueryBenchmarkNd(benchmark::State& state) {
+  static constexpr size_t kRanges = 1024;
+
+  std::array<size_t, NDims> dims;
+  dims.fill(size_t(state.range(0)));
+  auto as = generate(-100, +100, dims);
+  Engine e{algo::utility::asView(as)};
+
+  std::vector<decltype(e.getRangeQueryHandle())> handles(kRanges, e.getRangeQueryHandle());
+  for (auto& handle : handles) {
+    randomRange(handle.getRange().left, handle.getRange().right, dims);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(e.query(handles[i++ % kRanges]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
 template <typename Engine>
 void rqUpdateBenchmark(benchmark::State& state) {
   std::array<size_t, 1> dims = {size_t(state.range(0))};
@@ -61,8 +61,14 @@ void compareRangeEnginesMutable(const std::array<size_t, NDims>& dims, size_t sa
   }
 }
 
-template <typename EngineA, typename EngineB, typename Element = int, typename Output = int, size_t NDims = 1>
-void compareRangeEnginesMutableRange(const std::array<size_t, NDims>& dims, size_t samples) {
+/**
+ * @brief Compares range queries of the engines after range updates produced by generate_update().
+ */
+template <
+    typename EngineA, typename EngineB, typename Element = int, typename Output = int, size_t NDims = 1,
+    typename GenerateUpdate>
+void compareRangeEnginesMutableRange(
+    const std::array<size_t, NDims>& dims, size_t samples, const GenerateUpdate& generate_update) {
   auto as = generate<Element, NDims>(-10, 10, dims);
   EngineA engine_a{algo::utility::asView(as)};
   EngineB engine_b{algo::utility::asView(as)};
@@ -83,11 +89,18 @@ void compareRangeEnginesMutableRange(const std::array<size_t, NDims>& dims, size
     randomRange(ql, qr, dims);
     a_query_handle.getRange().left = b_query_handle.getRange().left = ql;
     a_query_handle.getRange().right = b_query_handle.getRange().right = qr;
-    auto value = std::uniform_int_distribution<Element>(-10, 10)(utility::random::generator());
+    auto value = generate_update();
 
     engine_a.updateRange(a_query_handle, value);
     engine_b.updateRange(b_query_handle, value);
   }
 }
 
+template <typename EngineA, typename EngineB, typename Element = int, typename Output = int, size_t NDims = 1>
+void compareRangeEnginesMutableRange(const std::array<size_t, NDims>& dims, size_t samples) {
+  compareRangeEnginesMutableRange<EngineA, EngineB, Element, Output>(dims, samples, [] {
+    return std::uniform_int_distribution<Element>(-10, 10)(utility::random::generator());
+  });
+}
+
 }  // namespace test::rq_utils
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <functional>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace test::rq_utils {
@@ -74,22 +75,26 @@ class NaiveRangeQueryEngine {
     view_.at(handle.getIndex()) = value;
   }
 
-  void updateRange(RangeQueryHandle& handle, const T& value) {
+  template <typename U>
+  void updateRange(RangeQueryHandle& handle, const U& value) {
     auto& [ul, ur] = handle.getRange();
     std::array<size_t, NDims> idxs;
     updateRange<0>(ul, ur, idxs, value);
   }
 
  private:
-  template <size_t I>
+  template <size_t I, typename U>
   void updateRange(
-      std::array<size_t, NDims>& ul, std::array<size_t, NDims>& ur, std::array<size_t, NDims>& idxs, const T& value) {
+      std::array<size_t, NDims>& ul, std::array<size_t, NDims>& ur, std::array<size_t, NDims>& idxs, const U& value) {
     for (size_t i = ul[I]; i <= ur[I]; ++i) {
       idxs[I] = i;
-      if constexpr (I == NDims - 1) {
-        view_.at(idxs) += value;
-      } else {
+      if constexpr (I < NDims - 1) {
         updateRange<I + 1>(ul, ur, idxs, value);
+      } else if constexpr (std::is_invocable_v<const U&, T&>) {
+        // Custom updates know how to apply themselves to a single element
+        value(view_.at(idxs));
+      } else {
+        view_.at(idxs) += value;
       }
     }
   }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "algo/segment_tree/segment_tree.h"
+#include "algo/segment_tree/simd_segment_tree.h"
+
+#include "test/algo/rq_utils/range_query.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace test::sgt {
+
+/**
+ * @brief For the underlying segment:
+ *  - stores minimal value,
+ *  - stores the count of values equal to minimal value.
+ */
+struct MinAndCountNode {
+  using value_type = int;
+  MinAndCountNode(value_type x) : min_value(x), min_count(1) {}
+
+  operator std::pair<int, int>() const {
+    return {min_value, min_count};
+  }
+
+  value_type min_value;
+  int min_count;
+};
+
+/**
+ * @brief Combines minimal values and their respective counts appropriately
+ */
+struct MinAndCountOp : public ::algo::sgt::base_op<MinAndCountNode, MinAndCountOp> {
+  using Node = MinAndCountNode;
+
+  Node neutral() const noexcept {
+    return Node(std::numeric_limits<int>::max());
+  }
+
+  void updateLeaf(Node& node, int value) {
+    node.min_value = value;
+  }
+
+  Node combine(const Node& left, const Node& right) {
+    Node node(std::min(left.min_value, right.min_value));
+    node.min_count = 0;
+    node.min_count += left.min_value == node.min_value ? left.min_count : 0;
+    node.min_count += right.min_value == node.min_value ? right.min_count : 0;
+    return node;
+  }
+};
+
+/**
+ * @brief For the underlying segment:
+ *  - stores sum of segment's values,
+ *  - optionally stores the value added to all its elements.
+ */
+struct SumAddNode {
+  using value_type = int64_t;
+  SumAddNode(value_type sum, int64_t size) : sum(sum), size(size) {}
+
+  operator int64_t() const noexcept {
+    return get_sum();
+  }
+  int64_t get_sum() const noexcept {
+    return sum + size * added;
+  }
+  void operator=(int64_t x) noexcept {
+    sum = x;
+  }
+
+  int64_t sum;
+  int64_t size;
+  int64_t added = 0;
+};
+
+/**
+ * @brief Operation for SumAddNode.
+ */
+struct SumAddOp : public ::algo::sgt::base_op<SumAddNode, SumAddOp> {
+  using Node = SumAddNode;
+
+  Node neutral() const noexcept {
+    return Node(0, 0);
+  }
+  Node init() const noexcept {
+    return Node(0, 1);
+  }
+
+  Node combine(const Node& left, const Node& right) {
+    return Node(left.get_sum() + right.get_sum(), left.size + right.size);
+  }
+
+  void push(Node& root, Node& left, Node& right) {
+    if (root.added == 0)
+      return;
+
+    left.added += root.added;
+    right.added += root.added;
+
+    root.sum = left.get_sum() + right.get_sum();
+    root.added = 0;
+  }
+
+  void updateLeaf(Node& node, int64_t value) {
+    node.added += value;
+  }
+  void updateRange(Node& node, int64_t value) {
+    node.added += value;
+  }
+};
+
+}  // namespace test::sgt
+
+namespace algo::sgt {
+
+template <typename T>
+struct simd_reduction<test::rq_utils::MinOp<T>> : std::integral_constant<SimdReduction, SimdReduction::kMin> {};
+
+template <typename T>
+struct simd_reduction<test::rq_utils::MaxOp<T>> : std::integral_constant<SimdReduction, SimdReduction::kMax> {};
+
+template <typename T>
+struct simd_reduction<test::rq_utils::SumOp<T>> : std::integral_constant<SimdReduction, SimdReduction::kSum> {};
+
+}  // namespace algo::sgt